@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 namespace mytho::core {
     template<typename GeneratorT, typename IdT>
     struct basic_id_generator {
@@ -7,16 +9,17 @@ namespace mytho::core {
 
         template<typename T>
         static value_type gen() noexcept {
-            static value_type id = _cur_id++;
+            static value_type id = _cur_id.fetch_add(1, std::memory_order_relaxed);
             return id;
         }
 
         template<auto E>
         static value_type gen() noexcept {
-            static value_type id = _cur_id++;
+            static value_type id = _cur_id.fetch_add(1, std::memory_order_relaxed);
             return id;
         }
 
-        inline static value_type _cur_id = 0;
+        // registries may run on different threads, e.g. a pipelined sub-registry, and meet new types at once
+        inline static std::atomic<value_type> _cur_id = 0;
     };
 }
\ No newline at end of file
@@ -0,0 +1,460 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+#elif defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#endif
+
+namespace mytho::core {
+    /*
+     * Chase-Lev work stealing deque, the owner thread pushes and pops at the bottom, other threads steal from the top.
+     * the ring grows when it is full, the old rings are kept until the deque is destroyed, so a thief never reads freed memory.
+     */
+    template<typename T>
+    requires std::is_trivially_copyable_v<T>
+    class basic_work_stealing_deque final {
+    public:
+        using value_type = T;
+        using index_type = int64_t;
+
+        static constexpr index_type initial_capacity = 64;
+
+    private:
+        struct ring {
+            explicit ring(index_type capacity)
+                : capacity(capacity), data(std::make_unique<std::atomic<value_type>[]>(capacity)) {}
+
+            void put(index_type idx, value_type value) noexcept {
+                data[idx & (capacity - 1)].store(value, std::memory_order_relaxed);
+            }
+
+            value_type get(index_type idx) const noexcept {
+                return data[idx & (capacity - 1)].load(std::memory_order_relaxed);
+            }
+
+            index_type capacity;
+            std::unique_ptr<std::atomic<value_type>[]> data;
+        };
+
+        using rings_type = std::vector<std::unique_ptr<ring>>;
+
+    public:
+        basic_work_stealing_deque() {
+            _rings.push_back(std::make_unique<ring>(initial_capacity));
+            _ring.store(_rings.back().get(), std::memory_order_relaxed);
+        }
+
+        basic_work_stealing_deque(const basic_work_stealing_deque& wsd) = delete;
+        basic_work_stealing_deque& operator=(const basic_work_stealing_deque& wsd) = delete;
+
+        ~basic_work_stealing_deque() = default;
+
+    public:
+        // owner thread only
+        void push(value_type value) {
+            auto b = _bottom.load(std::memory_order_relaxed);
+            auto t = _top.load(std::memory_order_acquire);
+            auto* r = _ring.load(std::memory_order_relaxed);
+
+            if (b - t >= r->capacity) {
+                r = grow(r, t, b);
+            }
+
+            r->put(b, value);
+            _bottom.store(b + 1, std::memory_order_release);
+        }
+
+        // owner thread only
+        std::optional<value_type> pop() {
+            auto b = _bottom.load(std::memory_order_relaxed) - 1;
+            auto* r = _ring.load(std::memory_order_relaxed);
+
+            // the bottom must be published before the top is read, so the owner and a thief never take the same value
+            _bottom.store(b, std::memory_order_seq_cst);
+            auto t = _top.load(std::memory_order_seq_cst);
+
+            if (t > b) {
+                _bottom.store(b + 1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+
+            auto value = r->get(b);
+
+            if (t == b) {
+                // the last value, race with the thieves for it
+                auto won = _top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                _bottom.store(b + 1, std::memory_order_relaxed);
+
+                if (!won) {
+                    return std::nullopt;
+                }
+            }
+
+            return value;
+        }
+
+        // any thread, fails if the deque is empty or another thread takes the value first
+        std::optional<value_type> steal() {
+            auto t = _top.load(std::memory_order_seq_cst);
+            auto b = _bottom.load(std::memory_order_seq_cst);
+
+            if (t >= b) {
+                return std::nullopt;
+            }
+
+            auto value = _ring.load(std::memory_order_acquire)->get(t);
+
+            if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return std::nullopt;
+            }
+
+            return value;
+        }
+
+    public:
+        bool empty() const noexcept {
+            return _bottom.load(std::memory_order_relaxed) <= _top.load(std::memory_order_relaxed);
+        }
+
+    private:
+        alignas(64) std::atomic<index_type> _top = 0;
+        alignas(64) std::atomic<index_type> _bottom = 0;
+        std::atomic<ring*> _ring = nullptr;
+        rings_type _rings;
+
+    private:
+        ring* grow(ring* r, index_type t, index_type b) {
+            auto bigger = std::make_unique<ring>(r->capacity * 2);
+            for (auto i = t; i < b; ++i) {
+                bigger->put(i, r->get(i));
+            }
+
+            _ring.store(bigger.get(), std::memory_order_release);
+            _rings.push_back(std::move(bigger));
+
+            return _rings.back().get();
+        }
+    };
+
+    class basic_task_pool;
+    class basic_task_scope;
+
+    namespace internal {
+        struct basic_task {
+            // run the task and destroy it
+            void(*invoke)(basic_task*);
+            basic_task_scope* scope;
+        };
+
+        template<typename FuncT>
+        struct basic_task_impl final : basic_task {
+            FuncT func;
+        };
+    }
+
+    // the tasks spawned in a scope are all finished when the scope waits or ends, the waiting thread runs tasks too
+    class basic_task_scope final {
+    public:
+        explicit basic_task_scope(basic_task_pool& pool) noexcept : _pool(pool) {}
+
+        basic_task_scope(const basic_task_scope& ts) = delete;
+        basic_task_scope& operator=(const basic_task_scope& ts) = delete;
+
+        ~basic_task_scope() { wait(); }
+
+    public:
+        template<typename FuncT>
+        void spawn(FuncT&& func);
+
+        void wait();
+
+    private:
+        basic_task_pool& _pool;
+        std::atomic<size_t> _pending = 0;
+
+        friend class basic_task_pool;
+    };
+
+    /*
+     * a work stealing thread pool, each worker owns a Chase-Lev deque:
+     *      the tasks spawned by a worker are pushed to its own deque and popped in LIFO order, which keeps the caches warm,
+     *      the tasks spawned by other threads are pushed to a shared injection queue,
+     *      an idle worker takes from its own deque, then the injection queue, then steals from the other workers.
+     * the workers sleep when there is no task, so an idle pool does not burn the cores.
+     */
+    class basic_task_pool final {
+    public:
+        using size_type = size_t;
+        using task_type = internal::basic_task*;
+        using deque_type = basic_work_stealing_deque<task_type>;
+        using affinity_type = std::vector<size_type>;
+
+        /*
+         * `thread_count` counts the caller thread, which works while it waits for a scope, 0 means the hardware concurrency.
+         * the i-th worker is pinned to the cpu `affinity[i % affinity.size()]`, the workers are not pinned if it is empty.
+         */
+        explicit basic_task_pool(size_type thread_count = 0, const affinity_type& affinity = {}) {
+            if (thread_count == 0) {
+                thread_count = std::max(1u, std::thread::hardware_concurrency());
+            }
+
+            for (size_type i = 1; i < thread_count; ++i) {
+                _workers.push_back(std::make_unique<worker_type>());
+            }
+
+            // the deques are all created before any worker starts stealing
+            auto size = _workers.size();
+            for (size_type i = 0; i < size; ++i) {
+                _workers[i]->thread = std::thread([this, i]() { work(i); });
+
+                if (!affinity.empty()) {
+                    pin(_workers[i]->thread, affinity[i % affinity.size()]);
+                }
+            }
+        }
+
+        basic_task_pool(const basic_task_pool& tp) = delete;
+        basic_task_pool& operator=(const basic_task_pool& tp) = delete;
+
+        ~basic_task_pool() {
+            {
+                std::lock_guard lock(_mutex);
+                _stop = true;
+            }
+
+            _wake.notify_all();
+
+            for (auto& worker : _workers) {
+                worker->thread.join();
+            }
+        }
+
+    public:
+        // `func(scope)` spawns tasks into the scope, returns after all of them are finished
+        template<typename FuncT>
+        void scope(FuncT&& func) {
+            basic_task_scope scope(*this);
+
+            func(scope);
+            scope.wait();
+        }
+
+        // call `func(i)` for each i in [begin, end), the range is split into chunks of at least `grain` indices
+        template<typename FuncT>
+        void parallel_for(size_type begin, size_type end, FuncT&& func, size_type grain = 1) {
+            if (begin >= end) {
+                return;
+            }
+
+            auto count = end - begin;
+            grain = std::max<size_type>(grain, 1);
+
+            // a few chunks per thread balance the load without flooding the deques
+            auto chunks = std::min((count + grain - 1) / grain, thread_count() * 4);
+            if (chunks < 2) {
+                for (auto i = begin; i < end; ++i) {
+                    func(i);
+                }
+
+                return;
+            }
+
+            auto chunk_size = (count + chunks - 1) / chunks;
+
+            scope([&func, begin, end, chunk_size](basic_task_scope& scope) {
+                for (auto first = begin + chunk_size; first < end; first += chunk_size) {
+                    auto last = std::min(first + chunk_size, end);
+
+                    scope.spawn([&func, first, last]() {
+                        for (auto i = first; i < last; ++i) {
+                            func(i);
+                        }
+                    });
+                }
+
+                // the caller takes the first chunk
+                auto last = std::min(begin + chunk_size, end);
+                for (auto i = begin; i < last; ++i) {
+                    func(i);
+                }
+            });
+        }
+
+    public:
+        size_type thread_count() const noexcept { return _workers.size() + 1; }
+
+    private:
+        struct worker_type {
+            deque_type deque;
+            std::thread thread;
+        };
+
+        struct current_type {
+            basic_task_pool* pool;
+            size_type index;
+        };
+
+        using workers_type = std::vector<std::unique_ptr<worker_type>>;
+
+        workers_type _workers;
+        std::deque<task_type> _injection;
+        std::mutex _injection_mutex;
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        std::atomic<size_type> _queued = 0;
+        std::atomic<size_type> _sleeping = 0;
+        bool _stop = false;
+
+        // the pool and the worker index of the current thread, null if it is not a worker
+        inline static thread_local current_type _current{ nullptr, 0 };
+
+        friend class basic_task_scope;
+
+    private:
+        void push(task_type task) {
+            if (_current.pool == this) {
+                _workers[_current.index]->deque.push(task);
+            } else {
+                std::lock_guard lock(_injection_mutex);
+                _injection.push_back(task);
+            }
+
+            _queued.fetch_add(1, std::memory_order_seq_cst);
+
+            // taking the lock makes sure a worker going to sleep sees the task or gets the notification
+            if (_sleeping.load(std::memory_order_seq_cst) > 0) {
+                { std::lock_guard lock(_mutex); }
+                _wake.notify_one();
+            }
+        }
+
+        task_type take() {
+            auto self = _current.pool == this ? _current.index : _workers.size();
+
+            if (self < _workers.size()) {
+                if (auto task = _workers[self]->deque.pop()) {
+                    return taken(task.value());
+                }
+            }
+
+            {
+                std::lock_guard lock(_injection_mutex);
+
+                if (!_injection.empty()) {
+                    auto task = _injection.front();
+                    _injection.pop_front();
+
+                    return taken(task);
+                }
+            }
+
+            auto size = _workers.size();
+            for (size_type i = 1; i <= size; ++i) {
+                auto victim = (self + i) % size;
+                if (victim == self) {
+                    continue;
+                }
+
+                if (auto task = _workers[victim]->deque.steal()) {
+                    return taken(task.value());
+                }
+            }
+
+            return nullptr;
+        }
+
+        task_type taken(task_type task) noexcept {
+            _queued.fetch_sub(1, std::memory_order_relaxed);
+
+            return task;
+        }
+
+        bool run_one() {
+            auto task = take();
+            if (!task) {
+                return false;
+            }
+
+            auto* scope = task->scope;
+            task->invoke(task);
+            scope->_pending.fetch_sub(1, std::memory_order_release);
+
+            return true;
+        }
+
+        void work(size_type index) {
+            _current = current_type{ this, index };
+
+            while (true) {
+                if (run_one()) {
+                    continue;
+                }
+
+                std::unique_lock lock(_mutex);
+
+                _sleeping.fetch_add(1, std::memory_order_seq_cst);
+                _wake.wait(lock, [this]() { return _stop || _queued.load(std::memory_order_seq_cst) > 0; });
+                _sleeping.fetch_sub(1, std::memory_order_relaxed);
+
+                if (_stop) {
+                    return;
+                }
+            }
+        }
+
+        static void pin(std::thread& thread, size_type cpu) noexcept {
+        #if defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+
+            pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &set);
+        #elif defined(_WIN32)
+            SetThreadAffinityMask(thread.native_handle(), DWORD_PTR(1) << cpu);
+        #endif
+        }
+    };
+
+    template<typename FuncT>
+    void basic_task_scope::spawn(FuncT&& func) {
+        using task_impl_type = internal::basic_task_impl<std::decay_t<FuncT>>;
+
+        auto* task = new task_impl_type{ { [](internal::basic_task* ptr) {
+            std::unique_ptr<task_impl_type> task(static_cast<task_impl_type*>(ptr));
+
+            task->func();
+        }, this }, std::forward<FuncT>(func) };
+
+        _pending.fetch_add(1, std::memory_order_relaxed);
+        _pool.push(task);
+    }
+
+    inline void basic_task_scope::wait() {
+        while (_pending.load(std::memory_order_acquire) > 0) {
+            if (!_pool.run_one()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
\ No newline at end of file
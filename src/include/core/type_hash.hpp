@@ -0,0 +1,101 @@
+#pragma once
+#include <string_view>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace mytho::core {
+    namespace internal {
+        template<typename T>
+        consteval std::string_view type_signature() {
+#if defined(__clang__) || defined(__GNUC__)
+            return __PRETTY_FUNCTION__;
+#elif defined(_MSC_VER)
+            return __FUNCSIG__;
+#else
+    #error Unsupported Compiler
+#endif
+        }
+
+        template<auto V>
+        consteval std::string_view value_signature() {
+#if defined(__clang__) || defined(__GNUC__)
+            return __PRETTY_FUNCTION__;
+#elif defined(_MSC_VER)
+            return __FUNCSIG__;
+#else
+    #error Unsupported Compiler
+#endif
+        }
+
+        /*
+         * the template argument in a signature:
+         *      g++:   consteval std::string_view mytho::core::internal::type_signature() [with T = foo::bar; ...]
+         *      clang: std::string_view mytho::core::internal::type_signature() [T = foo::bar]
+         *      msvc:  class std::basic_string_view<...> __cdecl mytho::core::internal::type_signature<struct foo::bar>(void)
+         */
+        consteval std::string_view signature_argument(std::string_view signature, std::string_view name) {
+#if defined(__clang__) || defined(__GNUC__)
+            auto start = signature.find(" = ", signature.find('[')) + 3;
+            auto end = signature.find_first_of(";]", start);
+#else
+            auto start = signature.find(name) + name.size() + 1;
+            auto end = signature.rfind(">(void)");
+
+            for (std::string_view keyword : { "struct ", "class ", "enum ", "union " }) {
+                if (signature.substr(start, keyword.size()) == keyword) {
+                    start += keyword.size();
+                }
+            }
+#endif
+            return signature.substr(start, end - start);
+        }
+
+        // a null terminated copy of a name in static storage
+        template<size_t N>
+        struct static_name {
+            consteval static_name(std::string_view name) {
+                for (size_t i = 0; i < N; ++i) {
+                    data[i] = name[i];
+                }
+            }
+
+            constexpr std::string_view view() const noexcept { return std::string_view(data.data(), N); }
+
+            std::array<char, N + 1> data{};
+        };
+
+        template<typename T>
+        inline constexpr auto type_name_v = static_name<signature_argument(type_signature<T>(), "type_signature").size()>(
+            signature_argument(type_signature<T>(), "type_signature"));
+
+        template<auto V>
+        inline constexpr auto value_name_v = static_name<signature_argument(value_signature<V>(), "value_signature").size()>(
+            signature_argument(value_signature<V>(), "value_signature"));
+    }
+
+    // FNV-1a hash of the signature of T, unlike `basic_id_generator` it is stable between runs of the same build
+    template<typename T>
+    consteval uint64_t type_hash() {
+        uint64_t hash = 14695981039346656037ull;
+
+        for (auto c : internal::type_signature<T>()) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    // the qualified name of T, e.g. `foo::bar`, for diagnostics such as traces
+    template<typename T>
+    constexpr std::string_view type_name() noexcept {
+        return internal::type_name_v<T>.view();
+    }
+
+    // the qualified name of an enumerator, e.g. `foo::color::red`
+    template<auto V>
+    constexpr std::string_view value_name() noexcept {
+        return internal::value_name_v<V>.view();
+    }
+}
\ No newline at end of file
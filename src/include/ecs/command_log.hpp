@@ -0,0 +1,307 @@
+#pragma once
+#include <vector>
+#include <optional>
+#include <unordered_map>
+#include <type_traits>
+#include <concepts>
+#include <limits>
+#include <utility>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+
+#include "core/assert.hpp"
+
+namespace mytho::ecs {
+    /*
+     * binary format of the components and resources in the command log.
+     * trivially copyable types are written as their bytes, other types must specialize:
+     *      template<> struct command_serializer<T> {
+     *          static void write(basic_command_writer& writer, const T& value);
+     *          static T read(basic_command_reader& reader);
+     *      };
+     * the commands carrying types without a format are not recorded, see `basic_command_log::skipped`.
+     */
+    template<typename T>
+    struct command_serializer {};
+
+    class basic_command_writer final {
+    public:
+        using data_type = std::vector<std::byte>;
+
+        explicit basic_command_writer(data_type& data) noexcept : _data(data) {}
+
+    public:
+        void write(const void* src, size_t size) {
+            auto offset = _data.size();
+
+            _data.resize(offset + size);
+            std::memcpy(_data.data() + offset, src, size);
+        }
+
+        template<typename T>
+        void write(const T& value) {
+            if constexpr (requires { command_serializer<T>::write(*this, value); }) {
+                command_serializer<T>::write(*this, value);
+            } else {
+                static_assert(std::is_trivially_copyable_v<T>, "type has no command serializer");
+
+                write(&value, sizeof(T));
+            }
+        }
+
+    private:
+        data_type& _data;
+    };
+
+    class basic_command_reader final {
+    public:
+        basic_command_reader(const std::byte* data, size_t size) noexcept : _ptr(data), _end(data + size) {}
+
+    public:
+        void read(void* dst, size_t size) noexcept {
+            ASSURE(size <= remain(), "command log is truncated");
+
+            std::memcpy(dst, _ptr, size);
+            _ptr += size;
+        }
+
+        template<typename T>
+        T read() {
+            if constexpr (requires { { command_serializer<T>::read(*this) } -> std::same_as<T>; }) {
+                return command_serializer<T>::read(*this);
+            } else {
+                static_assert(std::is_trivially_copyable_v<T>, "type has no command serializer");
+
+                alignas(T) std::byte buffer[sizeof(T)];
+                read(buffer, sizeof(T));
+
+                return *std::launder(reinterpret_cast<T*>(buffer));
+            }
+        }
+
+        // take the next `size` bytes as a reader
+        basic_command_reader sub(size_t size) noexcept {
+            ASSURE(size <= remain(), "command log is truncated");
+
+            basic_command_reader reader(_ptr, size);
+            _ptr += size;
+
+            return reader;
+        }
+
+    public:
+        size_t remain() const noexcept { return _end - _ptr; }
+
+        bool empty() const noexcept { return _ptr == _end; }
+
+    private:
+        const std::byte* _ptr;
+        const std::byte* _end;
+    };
+
+    template<typename T>
+    concept CommandSerializableType = std::is_trivially_copyable_v<T>
+        || requires(basic_command_writer& writer, basic_command_reader& reader, const T& value) {
+            command_serializer<T>::write(writer, value);
+            { command_serializer<T>::read(reader) } -> std::same_as<T>;
+        };
+
+    // a serializable command kind, the id is stable between runs of the same build
+    struct basic_command_kind final {
+        using recorder_type = void(*)(basic_command_writer&, const void*);
+
+        uint64_t id;
+        recorder_type recorder;
+    };
+
+    namespace internal {
+        // the state of replaying, recorded entities are mapped to the entities of the replaying registry
+        template<typename RegistryT>
+        class basic_command_replay final {
+        public:
+            using registry_type = RegistryT;
+            using entity_type = typename registry_type::entity_type;
+            using entities_type = std::unordered_map<uint64_t, entity_type>;
+
+            explicit basic_command_replay(registry_type& reg) noexcept : _reg(reg) {}
+
+        public:
+            registry_type& registry() noexcept { return _reg; }
+
+            // the recorded entity is spawned at its first reference
+            entity_type entity(const entity_type& e) {
+                if (auto mapped = find(e)) {
+                    return mapped.value();
+                }
+
+                auto mapped = _reg.spawn();
+                _entities[key(e)] = mapped;
+
+                return mapped;
+            }
+
+            std::optional<entity_type> find(const entity_type& e) const {
+                auto it = _entities.find(key(e));
+
+                if (it == _entities.end() || !_reg.alive(it->second)) {
+                    return std::nullopt;
+                }
+
+                return it->second;
+            }
+
+        private:
+            registry_type& _reg;
+            entities_type _entities;
+
+        private:
+            static uint64_t key(const entity_type& e) noexcept {
+                return (static_cast<uint64_t>(e.id()) << 32) | e.version();
+            }
+        };
+    }
+
+    /*
+     * a compact binary log of applied commands, recorded frame by frame:
+     *      frame:  [tick: u64][size: u64][command]...
+     *      command: [kind: u64][size: u32][payload]
+     * the log can be replayed into another registry of the same type, to reproduce the workload offline.
+     */
+    template<typename RegistryT>
+    class basic_command_log final {
+    public:
+        using registry_type = RegistryT;
+        using self_type = basic_command_log<registry_type>;
+        using data_type = std::vector<std::byte>;
+        using size_type = size_t;
+        using kind_type = basic_command_kind;
+        using replay_type = internal::basic_command_replay<registry_type>;
+        using replayer_type = void(*)(replay_type&, basic_command_reader&);
+        using replayers_type = std::unordered_map<uint64_t, replayer_type>;
+
+        static constexpr size_type frame_null = std::numeric_limits<size_type>::max();
+
+        basic_command_log() noexcept = default;
+
+        // load a recorded log
+        explicit basic_command_log(data_type data) noexcept : _data(std::move(data)) {
+            basic_command_reader reader(_data.data(), _data.size());
+
+            while (!reader.empty()) {
+                reader.template read<uint64_t>();
+                reader.sub(reader.template read<uint64_t>());
+
+                ++_frames;
+            }
+        }
+
+    public:
+        // called by the static initialization of command kinds, so logs can be replayed by another process
+        static bool add_kind(uint64_t id, replayer_type replayer) {
+            replayers()[id] = replayer;
+
+            return true;
+        }
+
+        void begin_frame(uint64_t tick) {
+            ASSURE(_frame == frame_null, "command log frame not ended");
+
+            basic_command_writer writer(_data);
+            writer.write(tick);
+
+            _frame = _data.size();
+            writer.write(uint64_t(0));
+        }
+
+        void end_frame() noexcept {
+            ASSURE(_frame != frame_null, "command log frame not began");
+
+            uint64_t size = _data.size() - _frame - sizeof(uint64_t);
+            std::memcpy(_data.data() + _frame, &size, sizeof(uint64_t));
+
+            _frame = frame_null;
+            ++_frames;
+        }
+
+        // kind is null if the command carries types which can not be serialized
+        void record(const kind_type* kind, const void* payload) {
+            if (!kind) {
+                ++_skipped;
+                return;
+            }
+
+            basic_command_writer writer(_data);
+            writer.write(kind->id);
+
+            auto offset = _data.size();
+            writer.write(uint32_t(0));
+
+            kind->recorder(writer, payload);
+
+            uint32_t size = _data.size() - offset - sizeof(uint32_t);
+            std::memcpy(_data.data() + offset, &size, sizeof(uint32_t));
+        }
+
+        // replay all frames into the registry, `on_frame(tick)` is called after each frame is replayed
+        template<typename FuncT>
+        void replay(registry_type& reg, FuncT&& on_frame) const {
+            replay_type replay(reg);
+            basic_command_reader reader(_data.data(), _data.size());
+
+            while (!reader.empty()) {
+                auto tick = reader.template read<uint64_t>();
+                auto frame = reader.sub(reader.template read<uint64_t>());
+
+                while (!frame.empty()) {
+                    auto id = frame.template read<uint64_t>();
+                    auto command = frame.sub(frame.template read<uint32_t>());
+
+                    auto it = replayers().find(id);
+                    ASSURE(it != replayers().end(), "unknown command kind");
+
+                    if (it != replayers().end()) {
+                        it->second(replay, command);
+                    }
+                }
+
+                on_frame(tick);
+            }
+        }
+
+        void replay(registry_type& reg) const {
+            replay(reg, [](uint64_t) {});
+        }
+
+        void clear() noexcept {
+            _data.clear();
+            _frame = frame_null;
+            _frames = 0;
+            _skipped = 0;
+        }
+
+    public:
+        const data_type& data() const noexcept { return _data; }
+
+        size_type frames() const noexcept { return _frames; }
+
+        // the number of commands not recorded, because they carry types which can not be serialized
+        size_type skipped() const noexcept { return _skipped; }
+
+        bool empty() const noexcept { return _data.empty(); }
+
+    private:
+        data_type _data;
+        size_type _frame = frame_null;
+        size_type _frames = 0;
+        size_type _skipped = 0;
+
+    private:
+        static replayers_type& replayers() {
+            static replayers_type replayers;
+
+            return replayers;
+        }
+    };
+}
\ No newline at end of file
@@ -2,189 +2,502 @@
 #include <vector>
 #include <array>
 #include <tuple>
+#include <memory>
+#include <new>
+#include <algorithm>
+#include <iterator>
+#include <ranges>
 #include <functional>
 #include <utility>
 #include <type_traits>
 #include <cstdint>
 #include <cstddef>
 
+#include "core/type_hash.hpp"
 #include "ecs/querier.hpp"
 #include "ecs/resources.hpp"
+#include "ecs/command_log.hpp"
 
 namespace mytho::ecs {
     namespace internal {
+        /*
+         * commands are recorded into a byte arena made of blocks, each command record is laid out as:
+         *      [header: executor, destroyer, kind, payload offset, record size][padding][payload]
+         * blocks are never moved once allocated and are reused after apply/clear,
+         * so recording commands does not allocate memory in steady state.
+         */
         template<typename RegistryT>
         class basic_command_queue final {
         public:
             using registry_type = RegistryT;
             using entity_type = typename registry_type::entity_type;
-            using executors_type = std::vector<void(*)(registry_type&, void*)>;
-            using destroyers_type = std::vector<void(*)(void*)>;
-            using buffers_type = std::vector<std::vector<uint8_t>>;
+            using executor_type = void(*)(registry_type&, void*);
+            using destroyer_type = void(*)(void*);
+            using command_log_type = basic_command_log<registry_type>;
+            using command_kind_type = typename command_log_type::kind_type;
+            using replay_type = typename command_log_type::replay_type;
+            using size_type = size_t;
+
+            static constexpr size_type block_size = 64 * 1024;
+            static constexpr size_type block_align = 64;
+
+        private:
+            struct command_header {
+                executor_type executor;
+                destroyer_type destroyer;
+                const command_kind_type* kind;
+                size_type payload_offset;
+                size_type size;
+            };
+
+            struct block_deleter {
+                void operator()(std::byte* ptr) const noexcept {
+                    ::operator delete(ptr, std::align_val_t{block_align});
+                }
+            };
+
+            struct command_block {
+                std::unique_ptr<std::byte, block_deleter> data;
+                size_type capacity = 0;
+                size_type used = 0;
+            };
+
+            using blocks_type = std::vector<command_block>;
 
         public:
+            basic_command_queue() noexcept = default;
+            basic_command_queue(const basic_command_queue& cq) = delete;
+            basic_command_queue(basic_command_queue&& cq) noexcept = default;
+
+            basic_command_queue& operator=(const basic_command_queue& cq) = delete;
+            basic_command_queue& operator=(basic_command_queue&& cq) noexcept = default;
+
+            ~basic_command_queue() { clear(); }
+
+        private:
+            /*
+             * command kinds, each kind defines:
+             *      payload_type: the data stored in the queue
+             *      execute: apply the payload to the registry
+             *      record/replay: write the payload to the command log and replay it, if the payload is serializable
+             */
             template<PureComponentType... Ts>
-            void spawn(Ts&&... ts) {
-                using tuple_type = std::tuple<Ts...>;
+            struct insert_batch_kind final {
+                using payload_type = std::pair<std::vector<entity_type>, std::vector<std::tuple<Ts...>>>;
 
-                _executors.push_back([](registry_type& reg, void* ptr) {
-                    auto* data = static_cast<tuple_type*>(ptr);
-                    std::apply([&reg](auto&&... args) {
-                        reg.spawn(std::move(args)...);
-                    }, std::move(*data));
-                });
+                static constexpr bool serializable = (CommandSerializableType<Ts> && ...);
 
-                if constexpr (std::is_trivially_destructible_v<tuple_type>) {
-                    _destroyers.push_back(nullptr);
-                } else {
-                    _destroyers.push_back([](void* ptr) {
-                        static_cast<tuple_type*>(ptr)->~tuple_type();
-                    });
+                static void execute(registry_type& reg, void* ptr) {
+                    auto& [entts, components] = *static_cast<payload_type*>(ptr);
+
+                    if constexpr (sizeof...(Ts) > 0) {
+                        reg.template reserve<Ts...>(entts.size());
+
+                        auto size = entts.size();
+                        for (size_t i = 0; i < size; ++i) {
+                            std::apply([&reg, &e = entts[i]](auto&&... ts) {
+                                reg.insert(e, std::move(ts)...);
+                            }, std::move(components[i]));
+                        }
+                    }
                 }
 
-                _buffers.emplace_back();
-                auto& buffer = _buffers.back();
-                buffer.resize(sizeof(tuple_type));
-                new (buffer.data()) tuple_type(std::forward<Ts>(ts)...);
-            }
+                static void record(basic_command_writer& writer, const void* ptr) {
+                    auto& [entts, components] = *static_cast<const payload_type*>(ptr);
 
-            void despawn(const entity_type& e) {
-                _executors.push_back([](registry_type& reg, void* ptr) {
-                    reg.despawn(*static_cast<entity_type*>(ptr));
-                });
+                    writer.write(uint64_t(entts.size()));
+
+                    auto size = entts.size();
+                    for (size_t i = 0; i < size; ++i) {
+                        writer.write(entts[i]);
+                        std::apply([&writer](const auto&... ts) { (writer.write(ts), ...); }, components[i]);
+                    }
+                }
 
-                _destroyers.push_back(nullptr);
+                static void replay(replay_type& replay, basic_command_reader& reader) {
+                    auto size = reader.template read<uint64_t>();
+                    for (uint64_t i = 0; i < size; ++i) {
+                        auto e = replay.entity(reader.template read<entity_type>());
 
-                _buffers.emplace_back();
-                auto& buffer = _buffers.back();
-                buffer.resize(sizeof(entity_type));
-                new (buffer.data()) entity_type(e);
-            }
+                        // braced initialization keeps the reading order
+                        std::tuple<Ts...> components{ reader.template read<Ts>()... };
+
+                        if constexpr (sizeof...(Ts) > 0) {
+                            std::apply([&replay, &e](auto&&... ts) {
+                                replay.registry().insert(e, std::move(ts)...);
+                            }, std::move(components));
+                        }
+                    }
+                }
+            };
+
+            struct despawn_kind final {
+                using payload_type = entity_type;
+
+                static constexpr bool serializable = true;
+
+                static void execute(registry_type& reg, void* ptr) {
+                    auto& e = *static_cast<entity_type*>(ptr);
+
+                    // several systems may despawn the same entity in a frame, only the first one takes effect
+                    if (reg.alive(e)) {
+                        reg.despawn(e);
+                    }
+                }
+
+                static void record(basic_command_writer& writer, const void* ptr) {
+                    writer.write(*static_cast<const entity_type*>(ptr));
+                }
+
+                static void replay(replay_type& replay, basic_command_reader& reader) {
+                    if (auto e = replay.find(reader.template read<entity_type>())) {
+                        replay.registry().despawn(e.value());
+                    }
+                }
+            };
+
+            template<QueryValueType... Filters>
+            struct despawn_all_kind final {
+                using payload_type = std::tuple<>;
+
+                static constexpr bool serializable = true;
+
+                static void execute(registry_type& reg, void* ptr) {
+                    reg.template despawn_all<Filters...>();
+                }
+
+                static void record(basic_command_writer& writer, const void* ptr) {}
+
+                static void replay(replay_type& replay, basic_command_reader& reader) {
+                    replay.registry().template despawn_all<Filters...>();
+                }
+            };
 
             template<PureComponentType... Ts>
-            void insert(const entity_type& e, Ts&&... ts) {
-                using tuple_type = std::tuple<entity_type, Ts...>;
+            struct insert_kind final {
+                using payload_type = std::tuple<entity_type, Ts...>;
+
+                static constexpr bool serializable = (CommandSerializableType<Ts> && ...);
 
-                _executors.push_back([](registry_type& reg, void* ptr) {
-                    auto* data = static_cast<tuple_type*>(ptr);
+                static void execute(registry_type& reg, void* ptr) {
                     std::apply([&reg](auto&&... args) {
                         reg.insert(std::move(args)...);
-                    }, std::move(*data));
-                });
+                    }, std::move(*static_cast<payload_type*>(ptr)));
+                }
 
-                if constexpr (std::is_trivially_destructible_v<tuple_type>) {
-                    _destroyers.push_back(nullptr);
-                } else {
-                    _destroyers.push_back([](void* ptr) {
-                        static_cast<tuple_type*>(ptr)->~tuple_type();
-                    });
+                static void record(basic_command_writer& writer, const void* ptr) {
+                    std::apply([&writer](const auto&... args) { (writer.write(args), ...); }, *static_cast<const payload_type*>(ptr));
                 }
 
-                _buffers.emplace_back();
-                auto& buffer = _buffers.back();
-                buffer.resize(sizeof(tuple_type));
-                new (buffer.data()) tuple_type(e, std::forward<Ts>(ts)...);
-            }
+                static void replay(replay_type& replay, basic_command_reader& reader) {
+                    auto e = replay.entity(reader.template read<entity_type>());
+                    std::tuple<Ts...> components{ reader.template read<Ts>()... };
+
+                    std::apply([&replay, &e](auto&&... ts) {
+                        replay.registry().insert(e, std::move(ts)...);
+                    }, std::move(components));
+                }
+            };
 
             template<PureComponentType... Ts>
-            void remove(const entity_type& e) {
-                _executors.push_back([](registry_type& reg, void* ptr) {
+            struct remove_kind final {
+                using payload_type = entity_type;
+
+                static constexpr bool serializable = true;
+
+                static void execute(registry_type& reg, void* ptr) {
                     reg.template remove<Ts...>(*static_cast<entity_type*>(ptr));
-                });
+                }
 
-                _destroyers.push_back(nullptr);
+                static void record(basic_command_writer& writer, const void* ptr) {
+                    writer.write(*static_cast<const entity_type*>(ptr));
+                }
 
-                _buffers.emplace_back();
-                auto& buffer = _buffers.back();
-                buffer.resize(sizeof(entity_type));
-                new (buffer.data()) entity_type(e);
-            }
+                static void replay(replay_type& replay, basic_command_reader& reader) {
+                    if (auto e = replay.find(reader.template read<entity_type>())) {
+                        replay.registry().template remove<Ts...>(e.value());
+                    }
+                }
+            };
 
             template<PureComponentType... Ts>
-            void replace(const entity_type& e, Ts&&... ts) {
-                using tuple_type = std::tuple<entity_type, Ts...>;
+            struct clear_kind final {
+                using payload_type = std::tuple<>;
+
+                static constexpr bool serializable = true;
+
+                static void execute(registry_type& reg, void* ptr) {
+                    reg.template clear<Ts...>();
+                }
+
+                static void record(basic_command_writer& writer, const void* ptr) {}
+
+                static void replay(replay_type& replay, basic_command_reader& reader) {
+                    replay.registry().template clear<Ts...>();
+                }
+            };
+
+            template<PureComponentType... Ts>
+            struct replace_kind final {
+                using payload_type = std::tuple<entity_type, Ts...>;
 
-                _executors.push_back([](registry_type& reg, void* ptr) {
-                    auto* data = static_cast<tuple_type*>(ptr);
+                static constexpr bool serializable = (CommandSerializableType<Ts> && ...);
+
+                static void execute(registry_type& reg, void* ptr) {
                     std::apply([&reg](auto&&... args) {
                         reg.replace(std::move(args)...);
-                    }, std::move(*data));
-                });
+                    }, std::move(*static_cast<payload_type*>(ptr)));
+                }
 
-                if constexpr (std::is_trivially_destructible_v<tuple_type>) {
-                    _destroyers.push_back(nullptr);
-                } else {
-                    _destroyers.push_back([](void* ptr) {
-                        static_cast<tuple_type*>(ptr)->~tuple_type();
-                    });
+                static void record(basic_command_writer& writer, const void* ptr) {
+                    std::apply([&writer](const auto&... args) { (writer.write(args), ...); }, *static_cast<const payload_type*>(ptr));
                 }
 
-                _buffers.emplace_back();
-                auto& buffer = _buffers.back();
-                buffer.resize(sizeof(tuple_type));
-                new (buffer.data()) tuple_type(e, std::forward<Ts>(ts)...);
-            }
+                static void replay(replay_type& replay, basic_command_reader& reader) {
+                    auto e = replay.find(reader.template read<entity_type>());
+                    std::tuple<Ts...> components{ reader.template read<Ts>()... };
+
+                    if (e) {
+                        std::apply([&replay, &e](auto&&... ts) {
+                            replay.registry().replace(e.value(), std::move(ts)...);
+                        }, std::move(components));
+                    }
+                }
+            };
 
             template<typename T, typename... Rs>
-            void init_resource(Rs&&... rs) {
-                using tuple_type = std::tuple<Rs...>;
+            struct init_resource_kind final {
+                using payload_type = std::tuple<Rs...>;
+
+                static constexpr bool serializable = (CommandSerializableType<Rs> && ...);
 
-                _executors.push_back([](registry_type& reg, void* ptr) {
-                    auto* data = static_cast<tuple_type*>(ptr);
+                static void execute(registry_type& reg, void* ptr) {
                     std::apply([&reg](auto&&... rs) {
                         reg.template init_resource<T>(std::move(rs)...);
-                    }, std::move(*data));
-                });
+                    }, std::move(*static_cast<payload_type*>(ptr)));
+                }
 
-                if constexpr (std::is_trivially_destructible_v<tuple_type>) {
-                    _destroyers.push_back(nullptr);
-                } else {
-                    _destroyers.push_back([](void* ptr) {
-                        static_cast<tuple_type*>(ptr)->~tuple_type();
-                    });
+                static void record(basic_command_writer& writer, const void* ptr) {
+                    std::apply([&writer](const auto&... rs) { (writer.write(rs), ...); }, *static_cast<const payload_type*>(ptr));
                 }
 
-                _buffers.emplace_back();
-                auto& buffer = _buffers.back();
-                buffer.resize(sizeof(tuple_type));
-                new (buffer.data()) tuple_type(std::forward<Rs>(rs)...);
-            }
+                static void replay(replay_type& replay, basic_command_reader& reader) {
+                    payload_type rs{ reader.template read<Rs>()... };
+
+                    std::apply([&replay](auto&&... rs) {
+                        replay.registry().template init_resource<T>(std::move(rs)...);
+                    }, std::move(rs));
+                }
+            };
 
             template<typename T>
-            void remove_resource() {
-                _executors.push_back([](registry_type& reg, void* ptr) {
+            struct remove_resource_kind final {
+                using payload_type = std::tuple<>;
+
+                static constexpr bool serializable = true;
+
+                static void execute(registry_type& reg, void* ptr) {
                     reg.template remove_resource<T>();
-                });
+                }
 
-                _destroyers.push_back(nullptr);
+                static void record(basic_command_writer& writer, const void* ptr) {}
 
-                _buffers.emplace_back();
-            }
+                static void replay(replay_type& replay, basic_command_reader& reader) {
+                    replay.registry().template remove_resource<T>();
+                }
+            };
 
         public:
-            void apply(registry_type& reg) {
-                auto size = _executors.size();
-                for (size_t i = 0; i < size; i++) {
-                    _executors[i](reg, _buffers[i].data());
+            template<PureComponentType... Ts>
+            void insert_batch(std::vector<entity_type>&& entts, std::vector<std::tuple<Ts...>>&& components) {
+                push<insert_batch_kind<Ts...>>(std::move(entts), std::move(components));
+            }
 
-                    if (_destroyers[i]) {
-                        _destroyers[i](_buffers[i].data());
+            void despawn(const entity_type& e) {
+                push<despawn_kind>(e);
+            }
+
+            template<QueryValueType... Filters>
+            void despawn_all() {
+                push<despawn_all_kind<Filters...>>();
+            }
+
+            template<PureComponentType... Ts>
+            void insert(const entity_type& e, Ts&&... ts) {
+                push<insert_kind<Ts...>>(e, std::forward<Ts>(ts)...);
+            }
+
+            template<PureComponentType... Ts>
+            void remove(const entity_type& e) {
+                push<remove_kind<Ts...>>(e);
+            }
+
+            template<PureComponentType... Ts>
+            void clear() {
+                push<clear_kind<Ts...>>();
+            }
+
+            template<PureComponentType... Ts>
+            void replace(const entity_type& e, Ts&&... ts) {
+                push<replace_kind<Ts...>>(e, std::forward<Ts>(ts)...);
+            }
+
+            template<typename T, typename... Rs>
+            void init_resource(Rs&&... rs) {
+                push<init_resource_kind<T, Rs...>>(std::forward<Rs>(rs)...);
+            }
+
+            template<typename T>
+            void remove_resource() {
+                push<remove_resource_kind<T>>();
+            }
+
+        public:
+            /*
+             * commands are applied one by one in record order, commands of the same entity are not regrouped:
+             * components live in separate sparse sets, so a structural change only touches the set of that component
+             * and there is no migration to save, while regrouping would reorder the hooks, observers and removed logs.
+             * the commands targeting a despawned entity are dropped by the registry.
+             */
+            void apply(registry_type& reg, command_log_type* log = nullptr) {
+                // commands recorded while applying are out of this range, they are dropped like before
+                auto blocks_size = _current + 1;
+                for (size_type i = 0; i < blocks_size && i < _blocks.size(); ++i) {
+                    auto& block = _blocks[i];
+                    auto used = block.used;
+
+                    for (size_type offset = 0; offset < used;) {
+                        auto* header = header_at(block, offset);
+                        void* payload = reinterpret_cast<std::byte*>(header) + header->payload_offset;
+
+                        if (log) {
+                            log->record(header->kind, payload);
+                        }
+
+                        header->executor(reg, payload);
+
+                        if (header->destroyer) {
+                            header->destroyer(payload);
+                        }
+
+                        offset = reinterpret_cast<std::byte*>(header) - block.data.get() + header->size;
                     }
                 }
 
-                clear();
+                reset();
             }
 
             void clear() noexcept {
-                _executors.clear();
-                _destroyers.clear();
-                _buffers.clear();
+                for (auto& block : _blocks) {
+                    auto used = block.used;
+
+                    for (size_type offset = 0; offset < used;) {
+                        auto* header = header_at(block, offset);
+
+                        if (header->destroyer) {
+                            header->destroyer(reinterpret_cast<std::byte*>(header) + header->payload_offset);
+                        }
+
+                        offset = reinterpret_cast<std::byte*>(header) - block.data.get() + header->size;
+                    }
+                }
+
+                reset();
             }
 
+        public:
+            bool empty() const noexcept { return _blocks.empty() || (_current == 0 && _blocks[0].used == 0); }
+
         private:
-            executors_type _executors{};
-            destroyers_type _destroyers{};
-            buffers_type _buffers{};
+            blocks_type _blocks{};
+            size_type _current = 0;
+
+        private:
+            static constexpr size_type align_up(size_type size, size_type align) noexcept {
+                return (size + align - 1) & ~(align - 1);
+            }
+
+            static command_header* header_at(command_block& block, size_type offset) noexcept {
+                return reinterpret_cast<command_header*>(block.data.get() + align_up(offset, alignof(command_header)));
+            }
+
+            // null if the kind is not serializable, the kind is registered to replay once it is used
+            template<typename KindT>
+            static const command_kind_type* kind() noexcept {
+                if constexpr (KindT::serializable) {
+                    static constexpr command_kind_type info{ mytho::core::type_hash<KindT>(), &KindT::record };
+                    (void)registered<KindT>;
+
+                    return &info;
+                } else {
+                    return nullptr;
+                }
+            }
+
+            template<typename KindT>
+            inline static const bool registered = command_log_type::add_kind(mytho::core::type_hash<KindT>(), &KindT::replay);
+
+            template<typename KindT, typename... Args>
+            void push(Args&&... args) {
+                using T = typename KindT::payload_type;
+
+                static_assert(alignof(T) <= block_align, "command payload is over-aligned");
+
+                destroyer_type destroyer = nullptr;
+                if constexpr (!std::is_trivially_destructible_v<T>) {
+                    destroyer = [](void* ptr) {
+                        static_cast<T*>(ptr)->~T();
+                    };
+                }
+
+                auto payload_offset = align_up(sizeof(command_header), alignof(T));
+                auto record_size = payload_offset + sizeof(T);
+
+                auto& block = assure(record_size + alignof(command_header));
+                auto header_offset = align_up(block.used, alignof(command_header));
+                auto* ptr = block.data.get() + header_offset;
+
+                new (ptr + payload_offset) T(std::forward<Args>(args)...);
+                new (ptr) command_header{ &KindT::execute, destroyer, kind<KindT>(), payload_offset, record_size };
+
+                block.used = header_offset + record_size;
+            }
+
+            // return the block which has enough space for the record
+            command_block& assure(size_type size) {
+                if (_blocks.empty()) {
+                    _blocks.push_back(make_block(size));
+                    _current = 0;
+                }
+
+                if (_blocks[_current].capacity - _blocks[_current].used >= size) {
+                    return _blocks[_current];
+                }
+
+                ++_current;
+                if (_current == _blocks.size()) {
+                    _blocks.push_back(make_block(size));
+                } else if (_blocks[_current].capacity < size) {
+                    _blocks[_current] = make_block(size);
+                }
+
+                return _blocks[_current];
+            }
+
+            static command_block make_block(size_type size) {
+                auto capacity = align_up(std::max(size, block_size), block_align);
+                auto* data = static_cast<std::byte*>(::operator new(capacity, std::align_val_t{block_align}));
+
+                return command_block{ std::unique_ptr<std::byte, block_deleter>(data), capacity, 0 };
+            }
+
+            void reset() noexcept {
+                for (auto& block : _blocks) {
+                    block.used = 0;
+                }
+
+                _current = 0;
+            }
         };
     }
 
@@ -194,18 +507,69 @@ namespace mytho::ecs {
         using registry_type = RegistryT;
         using self_type = basic_commands<registry_type>;
         using entity_type = typename registry_type::entity_type;
+        using command_queue_type = typename registry_type::command_queue_type;
+        using size_type = typename registry_type::size_type;
 
-        basic_commands(registry_type& reg, uint64_t tick) : _reg(reg), _tick(tick) {}
+        basic_commands(registry_type& reg, uint64_t tick) : _reg(reg), _queue(reg.command_queue()), _tick(tick) {}
+
+        basic_commands(registry_type& reg, uint64_t tick, command_queue_type& queue) : _reg(reg), _queue(queue), _tick(tick) {}
 
     public:
         // entity
+        // the entity is reserved at once, so the later commands can refer to it
         template<PureComponentType... Ts>
-        void spawn(Ts&&... ts) {
-            _reg.command_queue().spawn(std::forward<Ts>(ts)...);
+        entity_type spawn(Ts&&... ts) {
+            auto e = _reg.reserve_entity();
+
+            if constexpr (sizeof...(Ts) > 0) {
+                _queue.insert(e, std::forward<Ts>(ts)...);
+            }
+
+            return e;
+        }
+
+        // the entities are reserved at once, `generator(i)` is called at once too
+        template<typename GeneratorT>
+        requires std::is_invocable_v<GeneratorT&, size_type>
+        std::vector<entity_type> spawn_batch(size_type count, GeneratorT&& generator) {
+            using tuple_type = std::remove_cvref_t<std::invoke_result_t<GeneratorT&, size_type>>;
+
+            std::vector<tuple_type> components;
+            components.reserve(count);
+
+            for (size_type i = 0; i < count; ++i) {
+                components.push_back(generator(i));
+            }
+
+            return _spawn_batch(std::move(components));
+        }
+
+        template<std::ranges::sized_range RangeT>
+        std::vector<entity_type> spawn_batch(RangeT&& range) {
+            using tuple_type = std::remove_cvref_t<std::ranges::range_reference_t<RangeT>>;
+
+            std::vector<tuple_type> components;
+            components.reserve(std::ranges::size(range));
+
+            for (auto&& t : range) {
+                if constexpr (std::is_lvalue_reference_v<RangeT>) {
+                    components.push_back(t);
+                } else {
+                    components.push_back(std::move(t));
+                }
+            }
+
+            return _spawn_batch(std::move(components));
         }
 
         void despawn(const entity_type& e) {
-            _reg.command_queue().despawn(e);
+            _queue.despawn(e);
+        }
+
+        // the matching entities are collected when the command is applied, so the entities spawned before it are despawned too
+        template<QueryValueType... Filters>
+        void despawn_all() {
+            _queue.template despawn_all<Filters...>();
         }
 
     public:
@@ -213,19 +577,25 @@ namespace mytho::ecs {
         template<PureComponentType... Ts>
         requires (sizeof...(Ts) > 0)
         void insert(const entity_type& e, Ts&&... ts) {
-            _reg.command_queue().insert(e, std::forward<Ts>(ts)...);
+            _queue.insert(e, std::forward<Ts>(ts)...);
         }
 
         template<PureComponentType... Ts>
         requires (sizeof...(Ts) > 0)
         void remove(const entity_type& e) {
-            _reg.command_queue().template remove<Ts...>(e);
+            _queue.template remove<Ts...>(e);
+        }
+
+        template<PureComponentType... Ts>
+        requires (sizeof...(Ts) > 0)
+        void clear() {
+            _queue.template clear<Ts...>();
         }
 
         template<PureComponentType... Ts>
         requires (sizeof...(Ts) > 0)
         void replace(const entity_type& e, Ts&&... ts) {
-            _reg.command_queue().replace(e, std::forward<Ts>(ts)...);
+            _queue.replace(e, std::forward<Ts>(ts)...);
         }
 
         template<PureComponentType... Ts>
@@ -243,19 +613,19 @@ namespace mytho::ecs {
         template<PureComponentType... Ts>
         requires (sizeof...(Ts) > 0)
         bool components_removed() noexcept {
-            return _reg.template components_removed<Ts...>();
+            return _reg.template components_removed<Ts...>(_tick);
         }
 
     public:
         // resource
         template<typename T, typename... Rs>
         void init_resource(Rs&&... rs) {
-            _reg.command_queue().template init_resource<T>(std::forward<Rs>(rs)...);
+            _queue.template init_resource<T>(std::forward<Rs>(rs)...);
         }
 
         template<typename T>
         void remove_resource() {
-            _reg.command_queue().template remove_resource<T>();
+            _queue.template remove_resource<T>();
         }
 
         template<PureResourceType... Ts>
@@ -278,7 +648,7 @@ namespace mytho::ecs {
 
     public:
         self_type& apply() {
-            _reg.command_queue().apply(_reg);
+            _reg.apply_commands();
 
             return *this;
         }
@@ -290,7 +660,20 @@ namespace mytho::ecs {
 
     private:
         registry_type& _reg;
+        command_queue_type& _queue;
         uint64_t _tick;
+
+    private:
+        template<typename TupleT>
+        std::vector<entity_type> _spawn_batch(std::vector<TupleT>&& components) {
+            std::vector<entity_type> entts;
+            entts.reserve(components.size());
+
+            _reg.reserve_entities(components.size(), std::back_inserter(entts));
+            _queue.insert_batch(std::vector<entity_type>(entts), std::move(components));
+
+            return entts;
+        }
     };
 
     template<typename T>
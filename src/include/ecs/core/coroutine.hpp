@@ -0,0 +1,109 @@
+#pragma once
+
+#include <coroutine>
+#include <chrono>
+#include <exception>
+#include <utility>
+
+namespace mytho::ecs {
+    /*
+     * the return type of a system written as a coroutine, its work spans the runs of the system:
+     * each run resumes it until it awaits `next_frame` or a spent `budget_exhausted`, the next run resumes it from there,
+     * and a finished task starts over on the next run.
+     * the parameters are taken by reference, e.g. `Querier<Mut<Position>>& q`, they are constructed again before each resume,
+     * so the queries and resources always refer to the current run.
+     */
+    class basic_system_task final {
+    public:
+        using clock_type = std::chrono::steady_clock;
+        using duration_type = std::chrono::nanoseconds;
+        using time_point_type = typename clock_type::time_point;
+
+        struct promise_type {
+            time_point_type deadline = time_point_type::max();
+
+            basic_system_task get_return_object() noexcept {
+                return basic_system_task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            // the first resume runs the body, after the system set the budget
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+
+            std::suspend_always final_suspend() const noexcept { return {}; }
+
+            void return_void() const noexcept {}
+
+            void unhandled_exception() const noexcept { std::terminate(); }
+        };
+
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        basic_system_task() noexcept = default;
+
+        basic_system_task(basic_system_task&& task) noexcept : _handle(std::exchange(task._handle, nullptr)) {}
+
+        basic_system_task& operator=(basic_system_task&& task) noexcept {
+            if (this != &task) {
+                destroy();
+                _handle = std::exchange(task._handle, nullptr);
+            }
+
+            return *this;
+        }
+
+        basic_system_task(const basic_system_task& task) = delete;
+        basic_system_task& operator=(const basic_system_task& task) = delete;
+
+        ~basic_system_task() { destroy(); }
+
+    public:
+        // run until the task suspends, a zero budget never runs out, returns whether the task finished
+        bool resume(duration_type budget) {
+            _handle.promise().deadline = budget.count() > 0 ? clock_type::now() + budget : time_point_type::max();
+            _handle.resume();
+
+            return _handle.done();
+        }
+
+        bool valid() const noexcept { return static_cast<bool>(_handle); }
+
+    private:
+        handle_type _handle = nullptr;
+
+        explicit basic_system_task(handle_type handle) noexcept : _handle(handle) {}
+
+        void destroy() noexcept {
+            if (_handle) {
+                _handle.destroy();
+                _handle = nullptr;
+            }
+        }
+    };
+
+    namespace internal {
+        struct next_frame_awaiter {
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(basic_system_task::handle_type handle) const noexcept {}
+
+            void await_resume() const noexcept {}
+        };
+
+        struct budget_awaiter {
+            bool await_ready() const noexcept { return false; }
+
+            // resumes at once while the budget of the run lasts
+            bool await_suspend(basic_system_task::handle_type handle) const noexcept {
+                return basic_system_task::clock_type::now() >= handle.promise().deadline;
+            }
+
+            void await_resume() const noexcept {}
+        };
+    }
+
+    // suspend the task until the next run of its system
+    inline internal::next_frame_awaiter next_frame() noexcept { return {}; }
+
+    // suspend the task until the next run of its system if the budget of this run is spent, see `basic_system::budget`
+    inline internal::budget_awaiter budget_exhausted() noexcept { return {}; }
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <utility>
+
+namespace mytho::ecs {
+    /*
+     * the argument of the extract systems, see `basic_registry::init_pipeline`, e.g.
+     *      void extract(Querier<Position> q, Extract ext) { for (auto [pos] : q) ext->spawn(Snapshot{ pos->x }); }
+     * the sub-registry is idle while the extract schedule runs, the extract systems never run concurrently with each other.
+     */
+    template<typename RegistryT>
+    class basic_extract final {
+    public:
+        using registry_type = RegistryT;
+
+        explicit basic_extract(registry_type& sub) noexcept : _sub(sub) {}
+
+    public:
+        registry_type& registry() noexcept { return _sub; }
+
+        registry_type* operator->() noexcept { return &_sub; }
+
+    private:
+        registry_type& _sub;
+    };
+
+    // a thread running one job at a time, submitting a job waits for the previous one
+    class basic_pipeline_worker final {
+    public:
+        using job_type = std::function<void()>;
+
+        basic_pipeline_worker() : _thread([this]() { work(); }) {}
+
+        basic_pipeline_worker(const basic_pipeline_worker& worker) = delete;
+        basic_pipeline_worker& operator=(const basic_pipeline_worker& worker) = delete;
+
+        // the running job is finished first
+        ~basic_pipeline_worker() {
+            {
+                std::lock_guard lock(_mutex);
+                _stop = true;
+            }
+
+            _cv.notify_all();
+            _thread.join();
+        }
+
+    public:
+        void submit(job_type job) {
+            std::unique_lock lock(_mutex);
+            _cv.wait(lock, [this]() { return !_busy; });
+
+            _job = std::move(job);
+            _busy = true;
+
+            lock.unlock();
+            _cv.notify_all();
+        }
+
+        void wait() {
+            std::unique_lock lock(_mutex);
+            _cv.wait(lock, [this]() { return !_busy; });
+        }
+
+        bool busy() const {
+            std::lock_guard lock(_mutex);
+
+            return _busy;
+        }
+
+    private:
+        job_type _job;
+        bool _busy = false;
+        bool _stop = false;
+        mutable std::mutex _mutex;
+        std::condition_variable _cv;
+
+        // constructed last, the worker starts with the members above
+        std::thread _thread;
+
+    private:
+        void work() {
+            std::unique_lock lock(_mutex);
+
+            while (true) {
+                _cv.wait(lock, [this]() { return _busy || _stop; });
+
+                if (!_busy) {
+                    return;
+                }
+
+                auto job = std::move(_job);
+
+                lock.unlock();
+                job();
+                lock.lock();
+
+                _busy = false;
+                _cv.notify_all();
+            }
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <vector>
+#include <ostream>
+#include <string_view>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+namespace mytho::ecs {
+    /*
+     * the ordering and parallelism of the systems of a schedule, see `basic_registry::schedule_report`.
+     * an ambiguity is a pair of systems whose accesses conflict while no before/after path orders them,
+     * so they run in the order they are added, which is rarely what the author meant.
+     */
+    struct basic_schedule_report final {
+        using size_type = size_t;
+        using names_type = std::vector<std::string_view>;
+
+        struct system_type {
+            std::string_view name;
+            std::uintptr_t address;
+            size_type layer;
+            bool exclusive;
+        };
+
+        // the systems are indices into `systems`
+        struct edge_type {
+            size_type from;
+            size_type to;
+        };
+
+        struct ambiguity_type {
+            size_type first;
+            size_type second;
+            names_type components;
+            names_type resources;
+            bool exclusive;
+        };
+
+        std::string_view schedule;
+        std::vector<system_type> systems;
+        std::vector<edge_type> edges;
+        std::vector<ambiguity_type> ambiguities;
+
+        // the systems in each sorted layer, the most systems that may run at once in the layer
+        std::vector<size_type> layer_widths;
+
+    public:
+        // the systems in the longest before/after chain, the fewest steps the schedule takes with unlimited threads
+        size_type critical_path() const noexcept { return layer_widths.size(); }
+
+        size_type max_parallelism() const noexcept {
+            return layer_widths.empty() ? 0 : *std::max_element(layer_widths.begin(), layer_widths.end());
+        }
+
+        void write_text(std::ostream& os) const {
+            os << "schedule " << schedule << ": " << systems.size() << " systems, "
+               << layer_widths.size() << " layers, critical path " << critical_path()
+               << ", max parallelism " << max_parallelism() << "\n";
+
+            for (size_type i = 0; i < layer_widths.size(); ++i) {
+                os << "  layer " << i << ":";
+
+                for (auto& system : systems) {
+                    if (system.layer == i) {
+                        os << " " << system.name;
+                    }
+                }
+
+                os << "\n";
+            }
+
+            os << "  " << ambiguities.size() << " ambiguities\n";
+
+            for (auto& ambiguity : ambiguities) {
+                os << "    " << systems[ambiguity.first].name << " <-> " << systems[ambiguity.second].name << ":";
+                write_conflict(os, ambiguity, ", ");
+                os << "\n";
+            }
+        }
+
+        // the systems are ranked by layer, the ambiguities are dashed red edges labeled with the data they conflict on
+        void write_dot(std::ostream& os) const {
+            os << "digraph \"";
+            escape(os, schedule);
+            os << "\" {\n  rankdir=LR;\n  node [shape=box];\n";
+
+            for (size_type i = 0; i < systems.size(); ++i) {
+                os << "  s" << i << " [label=\"";
+                escape(os, systems[i].name);
+                os << "\"" << (systems[i].exclusive ? ", style=bold" : "") << "];\n";
+            }
+
+            for (size_type i = 0; i < layer_widths.size(); ++i) {
+                os << "  { rank=same;";
+
+                for (size_type j = 0; j < systems.size(); ++j) {
+                    if (systems[j].layer == i) {
+                        os << " s" << j << ";";
+                    }
+                }
+
+                os << " }\n";
+            }
+
+            for (auto& edge : edges) {
+                os << "  s" << edge.from << " -> s" << edge.to << ";\n";
+            }
+
+            for (auto& ambiguity : ambiguities) {
+                os << "  s" << ambiguity.first << " -> s" << ambiguity.second
+                   << " [dir=none, style=dashed, color=red, label=\"";
+                write_conflict(os, ambiguity, "\\n");
+                os << "\"];\n";
+            }
+
+            os << "}\n";
+        }
+
+    private:
+        static void write_conflict(std::ostream& os, const ambiguity_type& ambiguity, std::string_view separator) {
+            auto first = true;
+            auto write = [&](std::string_view kind, std::string_view name) {
+                os << (first ? " " : separator) << kind << " ";
+                escape(os, name);
+                first = false;
+            };
+
+            if (ambiguity.exclusive) {
+                write("exclusive", "registry");
+            }
+
+            for (auto name : ambiguity.components) {
+                write("component", name);
+            }
+
+            for (auto name : ambiguity.resources) {
+                write("resource", name);
+            }
+        }
+
+        static void escape(std::ostream& os, std::string_view s) {
+            for (auto c : s) {
+                if (c == '"' || c == '\\') {
+                    os << '\\';
+                }
+
+                os << c;
+            }
+        }
+    };
+}
\ No newline at end of file
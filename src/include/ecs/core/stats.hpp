@@ -0,0 +1,94 @@
+#pragma once
+
+#include <chrono>
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+
+// per-system timings, enabled by default in debug builds, see src/CMakeLists.txt
+#ifndef MYTHO_PROFILE_ENABLED
+    #define MYTHO_PROFILE_ENABLED 0
+#endif
+
+namespace mytho::ecs {
+    /*
+     * the timings of a system: the run counts, the entities its queries matched, and the wall time of its runs.
+     * the durations of the recent runs are kept in a ring buffer for the percentiles,
+     * and all runs are counted in a histogram of power of two buckets.
+     */
+    class basic_system_stats final {
+    public:
+        using clock_type = std::chrono::steady_clock;
+        using duration_type = std::chrono::nanoseconds;
+        using size_type = size_t;
+        using histogram_type = std::array<uint64_t, 64>;
+
+        static constexpr size_type window_size = 128;
+
+    public:
+        uint64_t runs() const noexcept { return _runs; }
+
+        // the runs skipped by the run conditions
+        uint64_t skips() const noexcept { return _skips; }
+
+        // the entities matched by the queries of all runs
+        uint64_t entities() const noexcept { return _entities; }
+
+        duration_type total() const noexcept { return _total; }
+
+        duration_type last() const noexcept { return _last; }
+
+        duration_type max() const noexcept { return _max; }
+
+        duration_type mean() const noexcept { return _runs == 0 ? duration_type::zero() : _total / static_cast<duration_type::rep>(_runs); }
+
+        // the p-th (0 to 1) percentile of the recent run durations
+        duration_type percentile(double p) const noexcept {
+            auto count = static_cast<size_type>(std::min<uint64_t>(_runs, window_size));
+            if (count == 0) {
+                return duration_type::zero();
+            }
+
+            auto samples = _window;
+            auto k = static_cast<size_type>(std::clamp(p, 0.0, 1.0) * (count - 1) + 0.5);
+            std::nth_element(samples.begin(), samples.begin() + k, samples.begin() + count);
+
+            return duration_type(samples[k]);
+        }
+
+        // bucket i counts the runs taking [2^(i-1), 2^i) nanoseconds, bucket 0 the runs taking no time
+        const histogram_type& histogram() const noexcept { return _histogram; }
+
+        void reset() noexcept { *this = basic_system_stats(); }
+
+    public:
+        // called by the system after each run
+        void record(duration_type duration, size_type entities) noexcept {
+            auto ns = static_cast<uint64_t>(std::max<duration_type::rep>(duration.count(), 0));
+
+            _window[_runs % window_size] = static_cast<duration_type::rep>(ns);
+            ++_histogram[std::min<size_type>(std::bit_width(ns), _histogram.size() - 1)];
+
+            ++_runs;
+            _entities += entities;
+            _total += duration;
+            _last = duration;
+            _max = std::max(_max, duration);
+        }
+
+        // called by the system when a run condition fails
+        void skip() noexcept { ++_skips; }
+
+    private:
+        uint64_t _runs = 0;
+        uint64_t _skips = 0;
+        uint64_t _entities = 0;
+        duration_type _total = duration_type::zero();
+        duration_type _last = duration_type::zero();
+        duration_type _max = duration_type::zero();
+        std::array<duration_type::rep, window_size> _window{};
+        histogram_type _histogram{};
+    };
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "core/assert.hpp"
+
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+namespace mytho::ecs {
+    // friend class pre-definition
+    class basic_fixed_time_helper;
+
+    /*
+     * the resource driving the fixed schedules, the frame time is accumulated and spent in steps of `timestep`.
+     * at most `max_steps` steps run in a frame, the time beyond them is dropped, so slow frames do not fall further behind.
+     */
+    class basic_fixed_time final {
+    public:
+        using duration_type = std::chrono::nanoseconds;
+        using size_type = size_t;
+
+        basic_fixed_time(duration_type timestep, size_type max_steps) : _timestep(timestep), _max_steps(max_steps) {
+            ASSURE(timestep.count() > 0, "fixed timestep must be positive");
+        }
+
+    public:
+        duration_type timestep() const noexcept { return _timestep; }
+
+        size_type max_steps() const noexcept { return _max_steps; }
+
+        // the time accumulated but not yet spent, always less than a timestep after the steps of a frame
+        duration_type accumulated() const noexcept { return _accumulated; }
+
+        // the number of steps run in the current frame
+        size_type steps() const noexcept { return _steps; }
+
+        uint64_t total_steps() const noexcept { return _total_steps; }
+
+        // the fraction of the next step already accumulated, to interpolate between the last two fixed states
+        double overstep() const noexcept { return double(_accumulated.count()) / double(_timestep.count()); }
+
+        void set_timestep(duration_type timestep) noexcept {
+            ASSURE(timestep.count() > 0, "fixed timestep must be positive");
+
+            _timestep = timestep;
+        }
+
+        void set_max_steps(size_type max_steps) noexcept { _max_steps = max_steps; }
+
+    protected:
+        size_type accumulate(duration_type delta) noexcept {
+            _accumulated += delta;
+
+            _steps = std::min<size_type>(_accumulated / _timestep, _max_steps);
+            _accumulated -= _timestep * _steps;
+            _accumulated %= _timestep;
+            _total_steps += _steps;
+
+            return _steps;
+        }
+
+    private:
+        duration_type _timestep;
+        duration_type _accumulated = duration_type::zero();
+        size_type _max_steps;
+        size_type _steps = 0;
+        uint64_t _total_steps = 0;
+
+        friend class basic_fixed_time_helper;
+    };
+
+    class basic_fixed_time_helper final {
+    public:
+        using duration_type = typename basic_fixed_time::duration_type;
+        using size_type = typename basic_fixed_time::size_type;
+
+    public:
+        // add the frame time, returns the number of steps to run in this frame
+        inline static size_type accumulate(basic_fixed_time& time, duration_type delta) noexcept {
+            return time.accumulate(delta);
+        }
+    };
+
+    /*
+     * paces the frames to a period, it sleeps until shortly before the deadline and then yields until it,
+     * so frames end on time without spinning a core for the whole wait.
+     * a late frame starts a new deadline, the next frames are not run back to back to catch up.
+     */
+    class basic_frame_limiter final {
+    public:
+        using clock_type = std::chrono::steady_clock;
+        using duration_type = std::chrono::nanoseconds;
+        using time_point_type = typename clock_type::time_point;
+
+        // sleeping may overshoot by the scheduler granularity, the last part of the wait yields instead
+        static constexpr duration_type yield_threshold = std::chrono::milliseconds(1);
+
+    public:
+        // a zero period disables the limiter
+        void set_period(duration_type period) noexcept {
+            _period = period;
+            _deadline = time_point_type{};
+        }
+
+        duration_type period() const noexcept { return _period; }
+
+        bool enabled() const noexcept { return _period.count() > 0; }
+
+        // called at the end of each frame
+        void wait() {
+            if (!enabled()) {
+                return;
+            }
+
+            auto now = clock_type::now();
+
+            if (_deadline != time_point_type{} && now < _deadline) {
+                if (_deadline - now > yield_threshold) {
+                    std::this_thread::sleep_until(_deadline - yield_threshold);
+                }
+
+                while (clock_type::now() < _deadline) {
+                    std::this_thread::yield();
+                }
+
+                _deadline += _period;
+            } else {
+                _deadline = now + _period;
+            }
+        }
+
+    private:
+        duration_type _period = duration_type::zero();
+        time_point_type _deadline{};
+    };
+}
\ No newline at end of file
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <ostream>
+#include <string_view>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+
+namespace mytho::ecs {
+    /*
+     * a timeline of frames, schedules, systems and command applies, written as Chrome trace event JSON,
+     * which chrome://tracing and Perfetto open.
+     * the events are recorded by `basic_trace_scope` markers into per-thread buffers, so parallel systems do not contend,
+     * the names are not copied, they must outlive the trace, such as string literals, type names and system names.
+     * `write` and `clear` must not overlap with recording, call them between frames.
+     */
+    class basic_trace final {
+    public:
+        using clock_type = std::chrono::steady_clock;
+        using time_point_type = typename clock_type::time_point;
+        using size_type = size_t;
+
+        struct event_type {
+            std::string_view name;
+            std::string_view category;
+            int64_t begin;
+            int64_t duration;
+            uint64_t id;
+        };
+
+        using events_type = std::vector<event_type>;
+
+        basic_trace() : _id(next_id()), _begin(clock_type::now()) {}
+
+        basic_trace(const basic_trace& trace) = delete;
+        basic_trace& operator=(const basic_trace& trace) = delete;
+
+    public:
+        // `id` is written as an argument of the event if it is not 0, e.g. the address of a system function
+        void record(std::string_view name, std::string_view category, time_point_type begin, time_point_type end, uint64_t id = 0) {
+            buffer().events.push_back(event_type{
+                name,
+                category,
+                std::chrono::duration_cast<std::chrono::nanoseconds>(begin - _begin).count(),
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count(),
+                id
+            });
+        }
+
+        // call `func(thread, event)` for each event, threads are numbered in the order they record their first event
+        template<typename FuncT>
+        void each(FuncT&& func) const {
+            std::lock_guard lock(_mutex);
+
+            for (auto& buffer : _buffers) {
+                for (auto& event : buffer.events) {
+                    func(buffer.index, event);
+                }
+            }
+        }
+
+        size_type size() const {
+            size_type size = 0;
+            each([&size](size_type, const event_type&) { ++size; });
+
+            return size;
+        }
+
+        void clear() {
+            std::lock_guard lock(_mutex);
+
+            for (auto& buffer : _buffers) {
+                buffer.events.clear();
+            }
+        }
+
+        void write(std::ostream& os) const {
+            std::lock_guard lock(_mutex);
+
+            os << "{\"traceEvents\":[";
+
+            auto first = true;
+            for (auto& buffer : _buffers) {
+                os << (first ? "" : ",") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.index
+                   << ",\"args\":{\"name\":\"thread " << buffer.index << "\"}}";
+                first = false;
+
+                for (auto& event : buffer.events) {
+                    os << ",{\"name\":\"";
+                    escape(os, event.name);
+                    os << "\",\"cat\":\"";
+                    escape(os, event.category);
+                    os << "\",\"ph\":\"X\",\"ts\":";
+                    microseconds(os, event.begin);
+                    os << ",\"dur\":";
+                    microseconds(os, event.duration);
+                    os << ",\"pid\":1,\"tid\":" << buffer.index;
+
+                    if (event.id) {
+                        char id[32];
+                        std::snprintf(id, sizeof(id), "0x%llx", static_cast<unsigned long long>(event.id));
+                        os << ",\"args\":{\"id\":\"" << id << "\"}";
+                    }
+
+                    os << "}";
+                }
+            }
+
+            os << "],\"displayTimeUnit\":\"ms\"}";
+        }
+
+    private:
+        struct buffer_type {
+            std::thread::id thread;
+            size_type index;
+            events_type events;
+        };
+
+        struct cache_type {
+            uint64_t trace;
+            buffer_type* buffer;
+        };
+
+        // a deque keeps the buffers in place, the threads cache pointers to them
+        using buffers_type = std::deque<buffer_type>;
+
+        uint64_t _id;
+        time_point_type _begin;
+        buffers_type _buffers;
+        mutable std::mutex _mutex;
+
+        inline static thread_local cache_type _cache{ 0, nullptr };
+
+    private:
+        buffer_type& buffer() {
+            if (_cache.trace == _id) {
+                return *_cache.buffer;
+            }
+
+            std::lock_guard lock(_mutex);
+
+            auto thread = std::this_thread::get_id();
+            buffer_type* found = nullptr;
+
+            for (auto& buffer : _buffers) {
+                if (buffer.thread == thread) {
+                    found = &buffer;
+                    break;
+                }
+            }
+
+            if (!found) {
+                found = &_buffers.emplace_back(buffer_type{ thread, _buffers.size(), {} });
+            }
+
+            _cache = cache_type{ _id, found };
+
+            return *found;
+        }
+
+        // traces never share an id, so a cache of a destroyed trace is never taken for a new one at the same address
+        static uint64_t next_id() noexcept {
+            static std::atomic<uint64_t> id = 0;
+
+            return ++id;
+        }
+
+        static void escape(std::ostream& os, std::string_view s) {
+            for (auto c : s) {
+                if (c == '"' || c == '\\') {
+                    os << '\\' << c;
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    os << ' ';
+                } else {
+                    os << c;
+                }
+            }
+        }
+
+        static void microseconds(std::ostream& os, int64_t ns) {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%lld.%03lld", static_cast<long long>(ns / 1000), static_cast<long long>(ns % 1000));
+
+            os << buffer;
+        }
+    };
+
+    // records an event from its construction to its destruction, does nothing if the trace is null
+    class basic_trace_scope final {
+    public:
+        using trace_type = basic_trace;
+        using clock_type = typename trace_type::clock_type;
+        using time_point_type = typename trace_type::time_point_type;
+
+        basic_trace_scope(trace_type* trace, std::string_view name, std::string_view category, uint64_t id = 0) noexcept
+            : _trace(trace), _name(name), _category(category), _id(id), _begin(trace ? clock_type::now() : time_point_type{}) {}
+
+        basic_trace_scope(const basic_trace_scope& scope) = delete;
+        basic_trace_scope& operator=(const basic_trace_scope& scope) = delete;
+
+        ~basic_trace_scope() {
+            if (_trace) {
+                _trace->record(_name, _category, _begin, clock_type::now(), _id);
+            }
+        }
+
+    private:
+        trace_type* _trace;
+        std::string_view _name;
+        std::string_view _category;
+        uint64_t _id;
+        time_point_type _begin;
+    };
+}
\ No newline at end of file
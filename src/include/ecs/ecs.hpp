@@ -23,6 +23,8 @@ namespace mecs {
     using Entity = mytho::ecs::basic_entity<uint32_t, uint8_t>;
     using Registry = mytho::ecs::basic_registry<Entity, uint16_t, uint16_t, uint8_t, 256>;
     using Commands = typename Registry::commands_type;
+    using CommandLog = typename Registry::command_log_type;
+    using TaskPool = typename Registry::task_pool_type;
 
     template<typename... Ts>
     using Querier = typename Registry::querier_type<Ts...>;
@@ -45,10 +47,27 @@ namespace mecs {
     template<typename T>
     using RemovedEntities = mytho::ecs::basic_removed_entities<Registry, T>;
 
+    template<typename T>
+    using Observer = mytho::ecs::basic_observer<Registry, T>;
+
+    using Extract = typename Registry::extract_type;
+
     using StartupSchedules = mytho::ecs::startup_schedules;
 
     using MainSchedules = mytho::ecs::main_schedules;
 
+    using FixedSchedules = mytho::ecs::fixed_schedules;
+
+    using ExtractSchedules = mytho::ecs::extract_schedules;
+
+    using FixedTime = mytho::ecs::basic_fixed_time;
+
+    using Trace = mytho::ecs::basic_trace;
+
+    using ScheduleReport = mytho::ecs::basic_schedule_report;
+
+    using Task = mytho::ecs::basic_system_task;
+
     template<typename T>
     using State = mytho::ecs::basic_state<T>;
 
@@ -66,6 +85,24 @@ namespace mecs {
         return Registry::system(std::forward<Func>(func));
     }
 
+    inline auto next_frame() noexcept {
+        return mytho::ecs::next_frame();
+    }
+
+    inline auto budget_exhausted() noexcept {
+        return mytho::ecs::budget_exhausted();
+    }
+
+    template<auto SetE>
+    auto system_set() {
+        return Registry::system_set<SetE>();
+    }
+
+    template<typename SetT>
+    auto system_set() {
+        return Registry::system_set<SetT>();
+    }
+
     template<auto... Funcs>
     constexpr auto all_of() {
         return mytho::ecs::all_of<Registry, Funcs...>();
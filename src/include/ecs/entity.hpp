@@ -1,5 +1,6 @@
 #pragma once
 #include <type_traits>
+#include <atomic>
 
 #include "core/concept.hpp"
 
@@ -50,19 +51,46 @@ namespace mytho::ecs {
         class data_wrapper {
         public:
             using data_type = T;
+            using notify_function_type = void(*)(void*, const uint64_t&);
 
-            data_wrapper(T* data, uint64_t& data_tick, uint64_t tick) : _data(data), _data_tick(data_tick), _tick(tick) {}
+            data_wrapper(T* data, uint64_t& data_tick, uint64_t tick) : data_wrapper(data, data_tick, data_tick, tick) {}
+
+            /*
+             * watermark_tick is the last changed tick of the whole container, see `basic_component_set`,
+             * notify is called with context and data_tick on mutable access if it is not null.
+             */
+            data_wrapper(T* data, uint64_t& data_tick, uint64_t& watermark_tick, uint64_t tick,
+                notify_function_type notify = nullptr, void* context = nullptr)
+                : _data(data), _data_tick(data_tick), _watermark_tick(watermark_tick), _tick(tick), _notify(notify), _context(context) {}
 
             const T* operator->() const noexcept { return _data; }
             const T& operator*() const noexcept { return *_data; }
 
-            T* operator->() noexcept { _data_tick = _tick; return _data; }
-            T& operator*() noexcept { _data_tick = _tick; return *_data; }
+            T* operator->() noexcept { changed(); return _data; }
+            T& operator*() noexcept { changed(); return *_data; }
+
+            // mutable accesses notify observers, which are not safe to notify from several threads
+            bool notifies() const noexcept { return _notify != nullptr; }
 
         private:
             T* _data = nullptr;
             uint64_t& _data_tick;
+            uint64_t& _watermark_tick;
             uint64_t _tick = 0;
+            notify_function_type _notify = nullptr;
+            void* _context = nullptr;
+
+        private:
+            void changed() {
+                _data_tick = _tick;
+
+                // the watermark is shared by the bundles of a container, which may be accessed in parallel, see `basic_querier::par_each`
+                std::atomic_ref(_watermark_tick).store(_tick, std::memory_order_relaxed);
+
+                if (_notify) {
+                    _notify(_context, _data_tick);
+                }
+            }
         };
 
         template<typename T, typename U>
@@ -1,8 +1,14 @@
 #pragma once
 #include <vector>
+#include <algorithm>
+#include <iterator>
+#include <tuple>
 #include <cstdint>
+#include <cstddef>
 
 #include "core/type_list.hpp"
+#include "core/task_pool.hpp"
+#include "storage/removed_log.hpp"
 #include "ecs/entity.hpp"
 
 namespace mytho::ecs::internal {
@@ -172,34 +178,123 @@ namespace mytho::ecs {
 
         iterator end() noexcept { return _component_bundles.end(); }
 
+        /*
+         * call `func(bundle)` for each bundle on the threads of the pool, in chunks of at least `grain` bundles,
+         * the bundles are called one by one on the caller thread if the pool is null, see `basic_registry::task_pool`,
+         * or if mutable accesses notify observers of changed components.
+         */
+        template<typename FuncT>
+        void par_each(mytho::core::basic_task_pool* pool, FuncT&& func, size_type grain = 64) {
+            if (!pool || (!empty() && notifies(_component_bundles.front()))) {
+                for (auto& bundle : _component_bundles) {
+                    func(bundle);
+                }
+
+                return;
+            }
+
+            pool->parallel_for(0, size(), [this, &func](size_type i) { func(_component_bundles[i]); }, grain);
+        }
+
     private:
         component_bundle_container_type _component_bundles;
+
+    private:
+        static bool notifies(const component_bundle_type& bundle) noexcept {
+            return std::apply([](const auto&... wrappers) {
+                return (wrapper_notifies(wrappers) || ...);
+            }, bundle);
+        }
+
+        template<typename T>
+        static bool wrapper_notifies(const T& wrapper) noexcept {
+            if constexpr (requires { wrapper.notifies(); }) {
+                return wrapper.notifies();
+            } else {
+                return false;
+            }
+        }
     };
 
     template<typename RegistryT, PureComponentType T>
     class basic_removed_entities final {
     public:
         using registry_type = RegistryT;
-        using entities_type = std::vector<typename registry_type::entity_type>;
+        using entity_type = typename registry_type::entity_type;
+        using removed_log_type = mytho::storage::basic_removed_log<entity_type>;
+        using cursor_type = typename removed_log_type::cursor_type;
+        using size_type = typename removed_log_type::size_type;
+
+        class iterator final {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = entity_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const entity_type*;
+            using reference = const entity_type&;
+
+            iterator() noexcept = default;
+            iterator(const removed_log_type* log, cursor_type cursor) noexcept : _log(log), _cursor(cursor) {}
+
+            reference operator*() const noexcept { return (*_log)[_cursor]; }
+            pointer operator->() const noexcept { return &(*_log)[_cursor]; }
+
+            iterator& operator++() noexcept { ++_cursor; return *this; }
+            iterator operator++(int) noexcept { auto it = *this; ++_cursor; return it; }
+
+            friend bool operator==(const iterator& l, const iterator& r) noexcept { return l._cursor == r._cursor; }
+
+        private:
+            const removed_log_type* _log = nullptr;
+            cursor_type _cursor = 0;
+        };
+
+        using const_iterator = iterator;
+
+        // read the records after the cursor, and move the cursor to the end of the log
+        basic_removed_entities(const removed_log_type& log, cursor_type& cursor) noexcept
+            : _log(log), _begin(std::max(cursor, log.tail())), _end(log.head()) {
+            cursor = _end;
+        }
+
+    public:
+        iterator begin() const noexcept { return iterator(&_log, _begin); }
+        iterator end() const noexcept { return iterator(&_log, _end); }
+
+        size_type size() const noexcept { return _end - _begin; }
+
+        bool empty() const noexcept { return size() == 0; }
+
+    private:
+        const removed_log_type& _log;
+        cursor_type _begin;
+        cursor_type _end;
+    };
+
+    // entities matching `added<Ts...>` or `changed<Ts...>` since the system last ran, collected as the changes happen
+    template<typename RegistryT, typename FilterT>
+    requires (is_added_v<FilterT> || is_changed_v<FilterT>)
+    class basic_observer final {
+    public:
+        using registry_type = RegistryT;
+        using entity_type = typename registry_type::entity_type;
+        using entities_type = std::vector<entity_type>;
         using size_type = typename entities_type::size_type;
-        using iterator = typename entities_type::iterator;
+        using iterator = typename entities_type::const_iterator;
         using const_iterator = typename entities_type::const_iterator;
 
-        basic_removed_entities(entities_type& entities) noexcept : _entities(entities) {}
+        basic_observer(const entities_type& entities) noexcept : _entities(entities) {}
 
     public:
-        iterator begin() noexcept { return _entities.begin(); }
-        iterator end() noexcept { return _entities.end(); }
-
-        const_iterator begin() const noexcept { return _entities.begin(); }
-        const_iterator end() const noexcept { return _entities.end(); }
+        iterator begin() const noexcept { return _entities.begin(); }
+        iterator end() const noexcept { return _entities.end(); }
 
         size_type size() const noexcept { return _entities.size(); }
 
         bool empty() const noexcept { return size() == 0; }
 
     private:
-        entities_type& _entities;
+        const entities_type& _entities;
     };
 
     template<typename T>
@@ -207,4 +302,7 @@ namespace mytho::ecs {
 
     template<typename T>
     inline constexpr bool is_removed_entities_v = mytho::core::is_template_v<T, basic_removed_entities>;
+
+    template<typename T>
+    inline constexpr bool is_observer_v = mytho::core::is_template_v<T, basic_observer>;
 }
\ No newline at end of file
@@ -5,7 +5,11 @@
 #include <type_traits>
 #include <utility>
 #include <vector>
+#include <ranges>
 #include <cstddef>
+#include <bit>
+#include <algorithm>
+#include <memory>
 
 #include "core/idgen.hpp"
 #include "core/mmem.hpp"
@@ -14,6 +18,8 @@
 #include "storage/resource_storage.hpp"
 #include "ecs/schedule.hpp"
 #include "ecs/core/state.hpp"
+#include "ecs/core/time.hpp"
+#include "ecs/core/trace.hpp"
 
 namespace mytho::ecs {
     namespace internal {
@@ -38,6 +44,18 @@ namespace mytho::ecs {
         Last
     };
 
+    // run 0..N times per frame before `main_schedules::Update`, see `basic_registry::init_fixed_time`
+    enum class fixed_schedules {
+        FixedPreUpdate,
+        FixedUpdate,
+        FixedPostUpdate
+    };
+
+    // run at the end of each frame to copy its data into the sub-registry, see `basic_registry::init_pipeline`
+    enum class extract_schedules {
+        Extract
+    };
+
     template<
         EntityType EntityT,
         mytho::core::UnsignedIntegralType ComponentIdT = uint16_t,
@@ -50,6 +68,7 @@ namespace mytho::ecs {
         enum class internal_schedules {
             Startup,
             StateSwitch,
+            FixedMain,
             Main
         };
 
@@ -68,10 +87,16 @@ namespace mytho::ecs {
         using component_storage_type = mytho::storage::basic_component_storage<entity_type, component_id_generator, std::allocator, PageSize>;
         using resource_storage_type = mytho::storage::basic_resource_storage<resource_id_generator, std::allocator>;
         using command_queue_type = internal::basic_command_queue<self_type>;
+        using command_log_type = basic_command_log<self_type>;
         using schedules_type = internal::basic_schedules<self_type>;
 
         using size_type = typename entity_storage_type::size_type;
         using system_type = typename schedules_type::system_type;
+        using system_set_type = typename schedules_type::system_set_type;
+        using schedule_report_type = typename schedules_type::report_type;
+        using schedule_reports_type = typename schedules_type::reports_type;
+        using task_pool_type = typename schedules_type::task_pool_type;
+        using task_pool_affinity_type = typename schedules_type::affinity_type;
         using entity_set_type = typename entity_storage_type::base_type;
 
         // system argument types
@@ -89,6 +114,11 @@ namespace mytho::ecs {
         template<typename T>
         using events_type = basic_events<T>;
 
+        template<typename T>
+        using observer_type = basic_observer<self_type, T>;
+
+        using extract_type = basic_extract<self_type>;
+
         template<typename T>
         using state_type = basic_state<T>;
 
@@ -104,6 +134,15 @@ namespace mytho::ecs {
         template<auto E>
         using on_exit_type = on_exit<E>;
 
+        using system_stats_type = basic_system_stats;
+        using fixed_time_type = basic_fixed_time;
+        using fixed_time_helper_type = basic_fixed_time_helper;
+        using frame_limiter_type = basic_frame_limiter;
+        using trace_type = basic_trace;
+        using pipeline_worker_type = basic_pipeline_worker;
+        using clock_type = typename frame_limiter_type::clock_type;
+        using duration_type = typename frame_limiter_type::duration_type;
+
         basic_registry() {
             _schedules.template add_startup_schedule<startup_schedules::PreStartup>()
                       .template add_startup_schedule<startup_schedules::Startup>()
@@ -117,19 +156,25 @@ namespace mytho::ecs {
                       .template add_update_schedule<internal_schedules::Main>()
                       .template set_default_schedule<main_schedules::Update>();
 
-            _schedules.template add_system<internal_schedules::Startup>(+[](commands_type cmds){
-                cmds.apply();
+            // applying commands changes the registry structure, these systems take the registry, so they are exclusive
+            auto startup_apply = system(+[](self_type& reg){
+                reg.apply_commands();
             });
 
-            _schedules.template add_system<internal_schedules::Main>(+[](commands_type cmds){
-                cmds.registry().removed_entities_clear();
-                cmds.apply();
+            auto main_apply = system(+[](self_type& reg){
+                reg.removed_entities_update();
+                reg.apply_commands();
             });
+
+            _schedules.template add_system<internal_schedules::Startup>(startup_apply.name("startup apply"));
+            _schedules.template add_system<internal_schedules::Main>(main_apply.name("main apply"));
         }
 
     public: // entity operations
         template<PureComponentType... Ts>
         entity_type spawn(Ts&&... ts) {
+            _entities.flush();
+
             auto e = _entities.emplace();
 
             if constexpr (sizeof...(Ts) > 0) {
@@ -145,10 +190,103 @@ namespace mytho::ecs {
         void despawn(const entity_type& e) {
             ASSURE(alive(e), "entity not alive");
 
-            _components.remove(e);
+            _entities.flush();
+
+            _components.remove(e, _current_tick);
             _entities.pop(e);
         }
 
+        /*
+         * despawn all entities matching the filters, e.g. `despawn_all<With<Bullet>>()`, no filter despawns every entity.
+         * the components are removed set by set, a set whose entities are all despawned is emptied at once.
+         * returns the number of despawned entities.
+         */
+        template<QueryValueType... Filters>
+        size_type despawn_all() {
+            _entities.flush();
+
+            std::vector<entity_type> entts;
+            for (auto& bundle : query<entity_type, Filters...>()) {
+                entts.push_back(*std::get<0>(bundle));
+            }
+
+            if (entts.empty()) {
+                return 0;
+            }
+
+            // group the entities by the components they have
+            typename component_storage_type::entity_groups_type groups(_components.size());
+            for (auto& e : entts) {
+                for (auto id : _entities.components(e)) {
+                    groups[id].push_back(e);
+                }
+            }
+
+            _components.remove_entities(groups, _current_tick);
+
+            for (auto& e : entts) {
+                _entities.pop(e);
+            }
+
+            return entts.size();
+        }
+
+        /*
+         * spawn `count` entities at once, `generator(i)` returns the components of the i-th entity as a tuple,
+         * the storages are reserved once before spawning.
+         */
+        template<typename GeneratorT>
+        requires std::is_invocable_v<GeneratorT&, size_type>
+        std::vector<entity_type> spawn_batch(size_type count, GeneratorT&& generator) {
+            using tuple_type = std::remove_cvref_t<std::invoke_result_t<GeneratorT&, size_type>>;
+
+            std::vector<entity_type> entts;
+            entts.reserve(count);
+
+            _spawn_batch(count, generator, entts, std::type_identity<tuple_type>{});
+
+            return entts;
+        }
+
+        // spawn an entity for each tuple of components in the range
+        template<std::ranges::sized_range RangeT>
+        std::vector<entity_type> spawn_batch(RangeT&& range) {
+            auto it = std::ranges::begin(range);
+
+            return spawn_batch(std::ranges::size(range), [&it](size_type) {
+                using tuple_type = std::remove_cvref_t<decltype(*it)>;
+
+                if constexpr (std::is_lvalue_reference_v<RangeT>) {
+                    return tuple_type(*it++);
+                } else {
+                    return tuple_type(std::move(*it++));
+                }
+            });
+        }
+
+        // reserve the storages for `count` more entities with components Ts
+        template<PureComponentType... Ts>
+        self_type& reserve(size_type count) {
+            _entities.flush();
+            _entities.reserve(_entities.size() + count);
+
+            if constexpr (sizeof...(Ts) > 0) {
+                _components.template reserve<Ts...>(count);
+            }
+
+            return *this;
+        }
+
+        // reserve an entity which becomes alive at the next spawn/despawn or commands apply, thread safe
+        entity_type reserve_entity() noexcept {
+            return _entities.reserve_entity();
+        }
+
+        template<typename OutputIt>
+        void reserve_entities(size_type count, OutputIt out) {
+            _entities.reserve_entities(count, out);
+        }
+
         bool alive(const entity_type& e) const noexcept {
             return e.valid() && _entities.contain(e);
         }
@@ -177,7 +315,14 @@ namespace mytho::ecs {
             }
 
             _entities.template remove<Ts...>(e);
-            _components.template remove<Ts...>(e);
+            _components.template remove<Ts...>(e, _current_tick);
+        }
+
+        // remove the components from all entities, each component set is emptied at once
+        template<PureComponentType... Ts>
+        requires (sizeof...(Ts) > 0)
+        void clear() {
+            (_clear<Ts>(), ...);
         }
 
         template<PureComponentType... Ts>
@@ -208,6 +353,17 @@ namespace mytho::ecs {
         template<PureComponentType... Ts>
         requires (sizeof...(Ts) > 0)
         bool components_added(uint64_t tick) noexcept {
+            if (!_components.template is_any_added<Ts...>(tick)) {
+                return false;
+            }
+
+            // the watermark is exact if none of the components is removed after the tick
+            if constexpr (sizeof...(Ts) == 1) {
+                if (!_components.template is_removed<Ts...>(tick)) {
+                    return true;
+                }
+            }
+
             auto id = _get_cid_with_minimun_entities<Ts...>();
 
             if (id) {
@@ -225,6 +381,17 @@ namespace mytho::ecs {
         template<PureComponentType... Ts>
         requires (sizeof...(Ts) > 0)
         bool components_changed(uint64_t tick) noexcept {
+            if (!_components.template is_any_changed<Ts...>(tick)) {
+                return false;
+            }
+
+            // the watermark is exact if none of the components is removed after the tick
+            if constexpr (sizeof...(Ts) == 1) {
+                if (!_components.template is_removed<Ts...>(tick)) {
+                    return true;
+                }
+            }
+
             auto id = _get_cid_with_minimun_entities<Ts...>();
 
             if (id) {
@@ -241,12 +408,12 @@ namespace mytho::ecs {
 
         template<PureComponentType... Ts>
         requires (sizeof...(Ts) > 0)
-        bool components_removed() noexcept {
-            return (!_components.template removed_entities<Ts>().empty() && ...);
+        bool components_removed(uint64_t tick) const noexcept {
+            return _components.template is_removed<Ts...>(tick);
         }
 
         template<PureComponentType T>
-        auto& removed_entities() noexcept {
+        const auto& removed_entities() const noexcept {
             return _components.template removed_entities<T>();
         }
 
@@ -270,6 +437,10 @@ namespace mytho::ecs {
 
             component_bundle_container_type component_bundles;
 
+            if (!component_list_any_added(tick, component_added_list{}) || !component_list_any_changed(tick, component_changed_list{})) {
+                return { std::move(component_bundles) };
+            }
+
             entts_type* entts_ptr = nullptr;
             if constexpr (component_contain_list::size == 0) {
                 entts_ptr = &_entities;
@@ -323,6 +494,10 @@ namespace mytho::ecs {
 
             size_type count = 0;
 
+            if (!component_list_any_added(tick, component_added_list{}) || !component_list_any_changed(tick, component_changed_list{})) {
+                return count;
+            }
+
             entts_type* entts_ptr = nullptr;
             if constexpr (component_contain_list::size == 0) {
                 entts_ptr = &_entities;
@@ -357,6 +532,41 @@ namespace mytho::ecs {
             return count;
         }
 
+    public: // observer operations
+        // create an observer collecting the entities which may match the filter, returns the observer id
+        template<typename FilterT>
+        requires (is_added_v<FilterT> || is_changed_v<FilterT>)
+        size_type observe() {
+            auto id = _components.add_observer();
+
+            _observe(id, FilterT{});
+
+            return id;
+        }
+
+        // drain the observer, the entities matching the filter since the tick are written to `entts`
+        template<typename FilterT, typename EntitiesT>
+        requires (is_added_v<FilterT> || is_changed_v<FilterT>)
+        void observed(size_type id, uint64_t tick, EntitiesT& entts) {
+            auto& observer = _components.observer(id);
+
+            entts.clear();
+
+            auto size = observer.size();
+            for (size_type i = 0; i < size; ++i) {
+                const auto e = observer[i];
+
+                if (_observed(e, tick, FilterT{})) {
+                    entts.push_back(e);
+                }
+            }
+
+            // remove one by one, so draining costs the number of records, not the range of entity ids
+            while (!observer.empty()) {
+                observer.remove(observer[observer.size() - 1]);
+            }
+        }
+
     public: // resource operations
         template<PureResourceType T, typename... Rs>
         self_type& init_resource(Rs&&... rs) {
@@ -420,6 +630,15 @@ namespace mytho::ecs {
             return (_resources.template is_changed<Ts>(tick) && ...);
         }
 
+        // the last tick any of the resources changed at
+        template<PureResourceType... Ts>
+        requires (sizeof...(Ts) > 0)
+        uint64_t resources_changed_tick() noexcept {
+            ASSURE(_resources.template exist<Ts>() && ..., "some resources not exist");
+
+            return std::max({ _resources.template get_changed_tick_ref<Ts>()... });
+        }
+
         template<PureResourceType... Ts>
         requires (sizeof...(Ts) > 0)
         bool resources_exist() const noexcept {
@@ -433,12 +652,14 @@ namespace mytho::ecs {
 
             _resources.template init<events_type<T>>(_current_tick);
 
-            _schedules.template add_system<internal_schedules::Main>(+[](resources_mut_type<events_type<T>> rm){
+            auto event_swap = system(+[](resources_mut_type<events_type<T>> rm){
                 auto& [events] = rm;
 
                 events->swap();
             });
 
+            _schedules.template add_system<internal_schedules::Main>(event_swap.name(mytho::core::type_name<events_type<T>>()));
+
             return *this;
         }
 
@@ -476,36 +697,109 @@ namespace mytho::ecs {
                          .template add_schedule<on_exit_type<V>>();
             });
 
+            // the state switch runs the on_exit/on_enter schedules in place, it takes the registry, so it is exclusive
+            auto state_switch = system(+[](self_type& reg, resources_mut_type<state_type<T>, next_state_type<T>> rsm){
+                auto [state, next_state] = rsm;
+                auto result = state_helper_type<T>::get_next_state(*next_state);
+                if (!result) {
+                    return;
+                }
+
+                T s = state->get();
+                T ns = result.value();
+                if (s == ns) {
+                    return;
+                }
+
+                // run state on_exit
+                mytho::core::enum_switch<T, 0, 128>([&reg]<auto V>(){
+                    reg.template run_schedule<on_exit_type<V>>();
+                }, s);
+
+                // run next_state on_enter
+                mytho::core::enum_switch<T, 0, 128>([&reg]<auto V>(){
+                    reg.template run_schedule<on_enter_type<V>>();
+                }, ns);
+
+                // update state/next_state
+                state_helper_type<T>::set_state(*state, ns);
+                state_helper_type<T>::reset_next_state(*next_state);
+            });
+
             _schedules.template add_schedule_before<internal_schedules::StateSwitch, main_schedules::Update>()
-                      .template add_system<internal_schedules::StateSwitch>(
-                        +[](commands_type cmds, resources_mut_type<state_type<T>, next_state_type<T>> rsm){
-                            auto [state, next_state] = rsm;
-                            auto result = state_helper_type<T>::get_next_state(*next_state);
-                            if (!result) {
-                                return;
-                            }
+                      .template add_system<internal_schedules::StateSwitch>(state_switch.name(mytho::core::type_name<state_type<T>>()));
+
+            return *this;
+        }
+
+    public: // fixed time operations
+        /*
+         * add the fixed schedules, which run every `timestep` of frame time before `main_schedules::Update`,
+         * a frame runs at most `max_steps` steps, the commands of each step are applied before the next one.
+         * systems read the `fixed_time_type` resource for the timestep and the overstep to interpolate.
+         */
+        self_type& init_fixed_time(duration_type timestep, size_type max_steps = 4) {
+            ASSURE(!_resources.template exist<fixed_time_type>(), "fixed time already exists");
 
-                            T s = state->get();
-                            T ns = result.value();
-                            if (s == ns) {
-                                return;
-                            }
+            _resources.template init<fixed_time_type>(_current_tick, timestep, max_steps);
 
-                            // run state on_exit
-                            mytho::core::enum_switch<T, 0, 128>([&cmds]<auto V>(){
-                                cmds.registry().template run_schedule<on_exit_type<V>>();
-                            }, s);
+            _schedules.template add_schedule<fixed_schedules::FixedPreUpdate>()
+                      .template add_schedule<fixed_schedules::FixedUpdate>()
+                      .template add_schedule<fixed_schedules::FixedPostUpdate>();
 
-                            // run next_state on_enter
-                            mytho::core::enum_switch<T, 0, 128>([&cmds]<auto V>(){
-                                cmds.registry().template run_schedule<on_enter_type<V>>();
-                            }, ns);
+            // the fixed main runs the fixed schedules in place, it takes the registry, so it is exclusive
+            auto fixed_main = system(+[](self_type& reg, resources_mut_type<fixed_time_type> rm){
+                auto [time] = rm;
 
-                            // update state/next_state
-                            state_helper_type<T>::set_state(*state, ns);
-                            state_helper_type<T>::reset_next_state(*next_state);
-                        }
-                      );
+                auto steps = fixed_time_helper_type::accumulate(*time, reg.frame_delta());
+                for (size_type i = 0; i < steps; ++i) {
+                    reg.template run_schedule<fixed_schedules::FixedPreUpdate>();
+                    reg.template run_schedule<fixed_schedules::FixedUpdate>();
+                    reg.template run_schedule<fixed_schedules::FixedPostUpdate>();
+
+                    reg.apply_commands();
+                }
+            });
+
+            _schedules.template add_schedule_before<internal_schedules::FixedMain, main_schedules::Update>()
+                      .template add_system<internal_schedules::FixedMain>(fixed_main.name("fixed main"));
+
+            return *this;
+        }
+
+    public: // pipeline operations
+        /*
+         * add a sub-registry whose frames run on another thread, one frame behind, e.g. for serialization or network snapshots:
+         *      frame N: the update schedules, then `extract_schedules::Extract`, then the sub-registry frame N starts,
+         *      frame N + 1: the update schedules run meanwhile, the extract waits for the sub-registry frame N to finish.
+         * the entities of the sub-registry are despawned before each extract, the extract systems take `extract_type`
+         * to spawn copies of the data they select, the resources of the sub-registry are kept.
+         * the sub-registry is configured like any registry through `sub_registry`, its startup runs with `startup`.
+         */
+        self_type& init_pipeline() {
+            ASSURE(!_sub_registry, "pipeline already exists");
+
+            _sub_registry = std::make_unique<self_type>();
+            _pipeline_worker = std::make_unique<pipeline_worker_type>();
+
+            _schedules.template add_schedule<extract_schedules::Extract>();
+
+            return *this;
+        }
+
+        self_type& sub_registry() noexcept {
+            ASSURE(_sub_registry, "pipeline not exists");
+
+            return *_sub_registry;
+        }
+
+        bool pipelined() const noexcept { return static_cast<bool>(_sub_registry); }
+
+        // wait for the running frame of the sub-registry, e.g. before reading its results from the main thread
+        self_type& wait_pipeline() {
+            if (_pipeline_worker) {
+                _pipeline_worker->wait();
+            }
 
             return *this;
         }
@@ -607,15 +901,131 @@ namespace mytho::ecs {
             return *this;
         }
 
+    public: // system set operations
+        // a set of systems sharing ordering and run conditions, the systems join it by `in_set`
+        template<auto SetE>
+        static system_set_type system_set() noexcept {
+            return system_set_type(internal::set_key<SetE>(), mytho::core::value_name<SetE>());
+        }
+
+        template<typename SetT>
+        static system_set_type system_set() noexcept {
+            return system_set_type(internal::set_key<SetT>(), mytho::core::type_name<SetT>());
+        }
+
+        // sets are configured per schedule, the systems of other schedules in the set are not affected
+        self_type& configure_set(system_set_type& set) {
+            _schedules.configure_set(set);
+
+            return *this;
+        }
+
+        template<auto ScheduleE>
+        self_type& configure_set(system_set_type& set) {
+            _schedules.template configure_set<ScheduleE>(set);
+
+            return *this;
+        }
+
+        template<typename ScheduleT>
+        self_type& configure_set(system_set_type& set) {
+            _schedules.template configure_set<ScheduleT>(set);
+
+            return *this;
+        }
+
     public: // core operations
+        // run the startup schedules, then the update schedules frame by frame until `exit` is called
         void run() {
-            _schedules.run(*this, _current_tick);
+            startup();
+
+            while (running()) {
+                update();
+            }
+
+            wait_pipeline();
+        }
+
+        /*
+         * step the registry from an outer loop instead of `run`:
+         *      reg.startup();
+         *      while (reg.running()) { reg.update(); }
+         * `startup` runs the startup schedules once, `update` runs one frame of the update schedules,
+         * the sorted schedules are cached between calls, so a frame costs only its systems.
+         */
+        self_type& startup() {
+            _schedules.startup(*this, _current_tick);
+
+            if (_sub_registry) {
+                _sub_registry->startup();
+            }
+
+            return *this;
+        }
+
+        // the frame time is measured from the previous frame, the first frame takes no time
+        self_type& update() {
+            auto now = clock_type::now();
+            auto delta = _last_frame == typename clock_type::time_point{} ? duration_type::zero() : duration_type(now - _last_frame);
+            _last_frame = now;
+
+            return update(delta);
+        }
+
+        // step one frame taking `delta` time, for deterministic stepping such as replays and lockstep servers
+        self_type& update(duration_type delta) {
+            _frame_delta = delta;
+
+            {
+                basic_trace_scope scope(_trace, "frame", "frame");
+                _schedules.update(*this, _current_tick);
+
+                if (_sub_registry) {
+                    _extract(delta);
+                }
+            }
+
+            _frame_limiter.wait();
+
+            return *this;
+        }
+
+        // the time of the current frame
+        duration_type frame_delta() const noexcept { return _frame_delta; }
+
+        // the tick the changes are marked with now, it advances with each system run
+        uint64_t current_tick() const noexcept { return _current_tick; }
+
+        // pace `update` to at most one frame per `period`, a zero period runs the frames as fast as possible
+        self_type& set_frame_limit(duration_type period) noexcept {
+            _frame_limiter.set_period(period);
+
+            return *this;
         }
 
         void exit() {
             _schedules.exit();
         }
 
+        // false after `exit` is called
+        bool running() const noexcept { return _schedules.running(); }
+
+        /*
+         * run the systems of each schedule on `count` threads, 0 means the hardware concurrency, 1 (default) runs them one by one.
+         * systems run concurrently when their accesses do not conflict, see `system_access_t`,
+         * so a system may only change the registry through its commands, unless it is exclusive: it takes `self_type&` or is added as `exclusive`.
+         * exclusive systems and systems added as `main_thread` run on the thread calling `update`.
+         * the workers are pinned to the cpus of `affinity` in turn, not pinned if it is empty.
+         */
+        self_type& set_thread_count(size_type count, const task_pool_affinity_type& affinity = {}) {
+            _schedules.set_thread_count(count, affinity);
+
+            return *this;
+        }
+
+        // the pool running the systems, null if they run one by one, systems may share it, see `basic_querier::par_each`
+        task_pool_type* task_pool() const noexcept { return _schedules.task_pool(); }
+
         template<auto ScheduleE>
         void run_schedule() {
             _schedules.template run_schedule<ScheduleE>(*this, _current_tick);
@@ -626,14 +1036,103 @@ namespace mytho::ecs {
             _schedules.template run_schedule<ScheduleT>(*this, _current_tick);
         }
 
+    public: // report operations
+        /*
+         * the layers, ordering edges and ambiguities of the systems of the schedule, see `basic_schedule_report`,
+         * e.g. `EXPECT_TRUE(reg.schedule_report<MainSchedules::Update>().ambiguities.empty())` in a test.
+         */
+        template<auto ScheduleE>
+        schedule_report_type schedule_report() {
+            return _schedules.template report<ScheduleE>();
+        }
+
+        template<typename ScheduleT>
+        schedule_report_type schedule_report() {
+            return _schedules.template report<ScheduleT>();
+        }
+
+        schedule_reports_type schedule_reports() {
+            return _schedules.reports();
+        }
+
+    #if MYTHO_PROFILE_ENABLED
+    public: // profile operations
+        // the timings of the system, null if it is not added, only compiled when MYTHO_PROFILE_ENABLED is set
+        template<mytho::core::FunctionType Func>
+        const system_stats_type* system_stats(Func&& func) noexcept {
+            using Fp = decltype(+std::declval<Func>());
+
+            Fp fp = +func;
+            auto system = _schedules.find_system(std::bit_cast<std::uintptr_t>(fp));
+
+            return system ? &system->stats() : nullptr;
+        }
+
+        // call `func(address, stats)` for each system, the address is the address of the system function
+        template<typename FuncT>
+        void each_system_stats(FuncT&& func) {
+            _schedules.each_system([&func](auto& system) {
+                func(system.address(), system.stats());
+            });
+        }
+
+        self_type& reset_system_stats() noexcept {
+            _schedules.each_system([](auto& system) {
+                system.reset_stats();
+            });
+
+            return *this;
+        }
+    #endif
+
     public: // command operations
         command_queue_type& command_queue() noexcept {
             return _command_queue;
         }
 
+        // apply the commands of every system in system order, then the commands recorded outside systems
+        self_type& apply_commands() {
+            basic_trace_scope scope(_trace, "apply commands", "commands");
+
+            _entities.flush();
+
+            if (_command_log) {
+                _command_log->begin_frame(_current_tick);
+            }
+
+            _schedules.apply_commands(*this, _command_log);
+            _command_queue.apply(*this, _command_log);
+
+            if (_command_log) {
+                _command_log->end_frame();
+            }
+
+            return *this;
+        }
+
+        // record the applied commands into the log from now on, pass nullptr to stop recording
+        self_type& record_commands(command_log_type* log) noexcept {
+            _command_log = log;
+
+            return *this;
+        }
+
+    public: // trace operations
+        /*
+         * record the frames, schedules, systems and command applies into the trace from now on, pass nullptr to stop recording.
+         * the trace is written as Chrome trace event JSON, see `basic_trace::write`.
+         */
+        self_type& record_trace(trace_type* trace) noexcept {
+            _trace = trace;
+
+            return *this;
+        }
+
+        trace_type* trace() const noexcept { return _trace; }
+
     public: // removed entities operations
-        self_type& removed_entities_clear() noexcept {
-            _components.removed_entities_clear();
+        self_type& removed_entities_update() noexcept {
+            _components.removed_entities_update();
 
             return *this;
         }
@@ -644,12 +1143,57 @@ namespace mytho::ecs {
         resource_storage_type _resources;
 
         command_queue_type _command_queue;
+        command_log_type* _command_log = nullptr;
+        trace_type* _trace = nullptr;
 
         // tick start from 1, and 0 is reserved for init
         uint64_t _current_tick = 1;
         schedules_type _schedules;
 
+        typename clock_type::time_point _last_frame{};
+        duration_type _frame_delta = duration_type::zero();
+        frame_limiter_type _frame_limiter;
+
+        // the worker is destroyed first, it finishes the running frame of the sub-registry
+        std::unique_ptr<self_type> _sub_registry;
+        std::unique_ptr<pipeline_worker_type> _pipeline_worker;
+
     private:
+        // the extract systems run while the sub-registry is idle, then its frame runs on the worker
+        void _extract(duration_type delta) {
+            {
+                basic_trace_scope scope(_trace, "wait pipeline", "frame");
+                _pipeline_worker->wait();
+            }
+
+            _sub_registry->despawn_all();
+            run_schedule<extract_schedules::Extract>();
+
+            _pipeline_worker->submit([sub = _sub_registry.get(), delta]() {
+                sub->update(delta);
+            });
+        }
+
+        template<typename GeneratorT, PureComponentType... Ts>
+        void _spawn_batch(size_type count, GeneratorT& generator, std::vector<entity_type>& entts, std::type_identity<std::tuple<Ts...>>) {
+            reserve<Ts...>(count);
+
+            for (size_type i = 0; i < count; ++i) {
+                auto e = _entities.template emplace<Ts...>();
+                if (!e.valid()) {
+                    break;
+                }
+
+                if constexpr (sizeof...(Ts) > 0) {
+                    std::apply([this, &e](auto&&... ts) {
+                        _components.add(e, _current_tick, std::forward<decltype(ts)>(ts)...);
+                    }, generator(i));
+                }
+
+                entts.push_back(e);
+            }
+        }
+
         template<typename T, typename... Rs>
         auto get_cid_with_minimun_entities(internal::type_list<T, Rs...>) noexcept {
             return _get_cid_with_minimun_entities<T, Rs...>();
@@ -730,6 +1274,60 @@ namespace mytho::ecs {
             }
         }
 
+        template<PureComponentType... Ts>
+        void _observe(size_type id, added<Ts...>) {
+            (_components.template observe_added<Ts>(id), ...);
+        }
+
+        template<PureComponentType... Ts>
+        void _observe(size_type id, changed<Ts...>) {
+            (_components.template observe_changed<Ts>(id), ...);
+        }
+
+        template<PureComponentType... Ts>
+        bool _observed(const entity_type& e, uint64_t tick, added<Ts...>) const noexcept {
+            return contain<Ts...>(e) && _components.template is_added<Ts...>(e, tick);
+        }
+
+        template<PureComponentType... Ts>
+        bool _observed(const entity_type& e, uint64_t tick, changed<Ts...>) const noexcept {
+            return contain<Ts...>(e) && _components.template is_changed<Ts...>(e, tick);
+        }
+
+        template<PureComponentType... Ts>
+        bool component_list_any_added(uint64_t tick, internal::type_list<Ts...>) const noexcept {
+            if constexpr (sizeof...(Ts) > 0) {
+                return _components.template is_any_added<Ts...>(tick);
+            } else {
+                return true;
+            }
+        }
+
+        template<PureComponentType... Ts>
+        bool component_list_any_changed(uint64_t tick, internal::type_list<Ts...>) const noexcept {
+            if constexpr (sizeof...(Ts) > 0) {
+                return _components.template is_any_changed<Ts...>(tick);
+            } else {
+                return true;
+            }
+        }
+
+        template<typename T>
+        void _clear() {
+            auto id = component_id_generator::template gen<T>();
+            if (id >= _components.size() || !_components[id]) {
+                return;
+            }
+
+            const auto& entts = *_components[id];
+            auto size = entts.size();
+            for (size_type i = 0; i < size; ++i) {
+                _entities.template remove<T>(entts[i]);
+            }
+
+            _components.template remove_all<T>(_current_tick);
+        }
+
         template<typename... Ts>
         auto _query(const entity_type& e, internal::type_list<Ts...>) noexcept {
             return std::tuple_cat(_query<Ts>(e)...);
@@ -744,11 +1342,15 @@ namespace mytho::ecs {
                 return std::tuple(internal::data_wrapper<entity_type>(e));
             } else {
                 auto id = component_id_generator::template gen<prototype>();
+                auto& cs = static_cast<component_set_type&>(*_components[id]);
                 return std::tuple(
                     internal::data_wrapper<T>(
-                        &(static_cast<component_set_type&>(*_components[id]).get(e)),
-                        static_cast<component_set_type&>(*_components[id]).changed_tick(e),
-                        _current_tick
+                        &cs.get(e),
+                        cs.changed_tick(e),
+                        cs.last_changed_tick(),
+                        _current_tick,
+                        cs.changed_observed() ? &component_set_type::notify_changed : nullptr,
+                        &cs
                     )
                 );
             }
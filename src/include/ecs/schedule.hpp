@@ -1,6 +1,13 @@
 #pragma once
+#include <memory>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <string_view>
 
 #include "ecs/system.hpp"
+#include "core/task_pool.hpp"
+#include "core/type_hash.hpp"
 
 namespace mytho::ecs::internal {
     template<typename RegistryT>
@@ -9,10 +16,21 @@ namespace mytho::ecs::internal {
         using registry_type = RegistryT;
         using self_type = basic_system_schedule<registry_type>;
 
+        // the systems are owned by the graph, see `basic_system_graph::sort`
         using meta_system_type = basic_meta_system<registry_type>;
-        using meta_systems_type = std::vector<meta_system_type>;
+        using meta_systems_type = std::vector<meta_system_type*>;
 
         using meta_systems_pool_type = std::vector<meta_systems_type>;
+        using command_log_type = typename registry_type::command_log_type;
+        using task_pool_type = mytho::core::basic_task_pool;
+
+        // the systems of a wave before `shared` run on any thread, the others on the thread running the schedule
+        struct wave_type {
+            meta_systems_type systems;
+            size_t shared = 0;
+        };
+
+        using waves_type = std::vector<wave_type>;
 
         basic_system_schedule() noexcept = default;
         basic_system_schedule(basic_system_schedule& ss) noexcept = delete;
@@ -20,22 +38,70 @@ namespace mytho::ecs::internal {
         basic_system_schedule(basic_system_schedule&& ss) noexcept
             : _meta_systems_pool(std::move(ss).meta_systems_pool()) {}
 
-        basic_system_schedule(meta_systems_pool_type&& pool) noexcept
+        basic_system_schedule(const meta_systems_pool_type& pool)
             : _meta_systems_pool(pool) {}
 
         basic_system_schedule& operator=(basic_system_schedule&& ss) noexcept {
             _meta_systems_pool = std::move(ss).meta_systems_pool();
+            _waves.clear();
 
             return *this;
         }
 
-        basic_system_schedule& operator=(meta_systems_pool_type&& pool) noexcept {
+        basic_system_schedule& operator=(const meta_systems_pool_type& pool) {
             _meta_systems_pool = pool;
+            _waves.clear();
 
             return *this;
         }
 
     public:
+        /*
+         * with a task pool, the systems run wave by wave, the systems of a wave run concurrently.
+         * each system gets the tick it would get if the systems ran one by one in wave order,
+         * except that the systems of a wave share the tick of the last one.
+         * an exclusive system is a wave of its own, it runs on the calling thread without going through the pool.
+         */
+        void run(registry_type& reg, uint64_t& tick, task_pool_type* pool) {
+            if (!pool || pool->thread_count() < 2) {
+                run(reg, tick);
+                return;
+            }
+
+            if (_waves.empty()) {
+                build_waves();
+            }
+
+            for (auto& wave : _waves) {
+                auto& systems = wave.systems;
+                tick += systems.size();
+
+                auto system_tick = tick - 1;
+                auto task = [&reg, &systems, system_tick](size_t i) {
+                    (*systems[i])(reg, system_tick);
+                };
+
+                if (systems.size() == 1) {
+                    task(0);
+                } else if (wave.shared == systems.size()) {
+                    pool->parallel_for(0, systems.size(), task);
+                } else {
+                    // the workers take the shared systems while this thread runs the main thread ones, then helps them
+                    mytho::core::basic_task_scope scope(*pool);
+
+                    for (size_t i = 0; i < wave.shared; ++i) {
+                        scope.spawn([&task, i]() { task(i); });
+                    }
+
+                    for (size_t i = wave.shared; i < systems.size(); ++i) {
+                        task(i);
+                    }
+
+                    scope.wait();
+                }
+            }
+        }
+
         void run(registry_type& reg, uint64_t& tick) {
             auto size = _meta_systems_pool.size();
             for (auto i = 0; i < size; ++i) {
@@ -43,22 +109,74 @@ namespace mytho::ecs::internal {
                 auto in_size = systems.size();
 
                 for (auto j = 0; j < in_size; ++j) {
-                    auto& system = systems[j];
+                    auto& system = *systems[j];
 
                     system(reg, tick++);
                 }
             }
         }
 
+        // apply the commands recorded by the systems, in the order the systems run
+        void apply_commands(registry_type& reg, command_log_type* log) {
+            for (auto& systems : _meta_systems_pool) {
+                for (auto& system : systems) {
+                    system->apply_commands(reg, log);
+                }
+            }
+        }
+
     public:
         auto meta_systems_pool() && noexcept { return std::move(_meta_systems_pool); }
 
         auto size() const noexcept { return _meta_systems_pool.size(); }
 
-        void clear() noexcept { _meta_systems_pool.clear(); }
+        void clear() noexcept {
+            _meta_systems_pool.clear();
+            _waves.clear();
+        }
 
     private:
         meta_systems_pool_type _meta_systems_pool;
+        waves_type _waves;
+
+    private:
+        /*
+         * split each sorted layer into waves of systems whose accesses do not conflict,
+         * a system is placed after every conflicting system before it in the layer, so conflicting systems keep their order,
+         * and the layers keep their order, so the before/after constraints hold.
+         * the exclusive systems are last in their layer, see `basic_system_graph::kahn`, so they only split the waves after the others.
+         */
+        void build_waves() {
+            _waves.clear();
+
+            std::vector<size_t> levels;
+            for (auto& systems : _meta_systems_pool) {
+                auto first = _waves.size();
+                auto size = systems.size();
+
+                levels.assign(size, 0);
+                for (size_t i = 0; i < size; ++i) {
+                    for (size_t j = 0; j < i; ++j) {
+                        if (systems[j]->access().conflict(systems[i]->access())) {
+                            levels[i] = std::max(levels[i], levels[j] + 1);
+                        }
+                    }
+
+                    if (first + levels[i] >= _waves.size()) {
+                        _waves.resize(first + levels[i] + 1);
+                    }
+
+                    _waves[first + levels[i]].systems.push_back(systems[i]);
+                }
+            }
+
+            for (auto& wave : _waves) {
+                auto& systems = wave.systems;
+                auto it = std::stable_partition(systems.begin(), systems.end(), [](auto system) { return !system->main_thread(); });
+
+                wave.shared = it - systems.begin();
+            }
+        }
     };
 
     template<typename RegistryT>
@@ -73,14 +191,23 @@ namespace mytho::ecs::internal {
         using schedule_id_generator = typename registry_type::schedule_id_generator;
         using schedule_id_type = typename schedule_id_generator::value_type;
         using system_type = typename system_graph_type::system_type;
+        using system_set_type = typename system_graph_type::system_set_type;
+        using meta_system_type = typename system_graph_type::meta_system_type;
+        using condition_cache_type = typename meta_system_type::condition_cache_type;
+        using report_type = typename system_graph_type::report_type;
+        using reports_type = std::vector<report_type>;
+        using task_pool_type = typename system_schedule_type::task_pool_type;
+        using size_type = typename task_pool_type::size_type;
+        using affinity_type = typename task_pool_type::affinity_type;
 
     private:
         struct basic_schedule {
             basic_schedule() noexcept = default;
-            basic_schedule(schedule_id_type id, system_schedule_type&& schedule) noexcept
-                : _key(id), _schedule(std::move(schedule)) {}
+            basic_schedule(schedule_id_type id, std::string_view name, system_schedule_type&& schedule) noexcept
+                : _key(id), _name(name), _schedule(std::move(schedule)) {}
 
             schedule_id_type _key;
+            std::string_view _name;
             system_schedule_type _schedule;
         };
 
@@ -89,6 +216,7 @@ namespace mytho::ecs::internal {
         using schedules_type = std::vector<schedule_type>;
         using graphs_type = std::vector<system_graph_type>;
         using schedule_index_type = typename schedules_type::size_type;
+        using schedule_indices_type = std::vector<schedule_index_type>;
 
         inline static constexpr schedule_index_type schedule_index_null = std::numeric_limits<schedule_index_type>::max();
 
@@ -99,8 +227,10 @@ namespace mytho::ecs::internal {
 
             ASSURE(_index(id) == schedule_index_null, "new schedule already exists!");
 
-            _schedules.insert(_schedules.begin() + _startup_end_index, schedule_type(id, system_schedule_type()));
+            _schedules.insert(_schedules.begin() + _startup_end_index, schedule_type(id, _name<ScheduleE>(), system_schedule_type()));
             _graphs.insert(_graphs.begin() + _startup_end_index, system_graph_type());
+            _reindex(_startup_end_index);
+            _shift_default(_startup_end_index);
 
             ++_startup_end_index;
             ++_update_end_index;
@@ -114,8 +244,10 @@ namespace mytho::ecs::internal {
 
             ASSURE(_index(id) == schedule_index_null, "new schedule already exists!");
 
-            _schedules.insert(_schedules.begin() + _update_end_index, schedule_type(id, system_schedule_type()));
+            _schedules.insert(_schedules.begin() + _update_end_index, schedule_type(id, _name<ScheduleE>(), system_schedule_type()));
             _graphs.insert(_graphs.begin() + _update_end_index, system_graph_type());
+            _reindex(_update_end_index);
+            _shift_default(_update_end_index);
 
             ++_update_end_index;
 
@@ -128,8 +260,9 @@ namespace mytho::ecs::internal {
 
             ASSURE(_index(id) == schedule_index_null, "new schedule already exists!");
 
-            _schedules.emplace_back(schedule_type(id, system_schedule_type()));
+            _schedules.emplace_back(schedule_type(id, _name<ScheduleE>(), system_schedule_type()));
             _graphs.emplace_back(system_graph_type());
+            _reindex(_schedules.size() - 1);
 
             return *this;
         }
@@ -140,8 +273,9 @@ namespace mytho::ecs::internal {
 
             ASSURE(_index(id) == schedule_index_null, "new schedule already exists!");
 
-            _schedules.emplace_back(schedule_type(id, system_schedule_type()));
+            _schedules.emplace_back(schedule_type(id, _name<ScheduleT>(), system_schedule_type()));
             _graphs.emplace_back(system_graph_type());
+            _reindex(_schedules.size() - 1);
 
             return *this;
         }
@@ -157,8 +291,10 @@ namespace mytho::ecs::internal {
 
             ASSURE(idx != schedule_index_null, "before-schedule not exist!");
 
-            _schedules.insert(_schedules.begin() + idx, schedule_type(id, system_schedule_type()));
+            _schedules.insert(_schedules.begin() + idx, schedule_type(id, _name<ScheduleE>(), system_schedule_type()));
             _graphs.insert(_graphs.begin() + idx, system_graph_type());
+            _reindex(idx);
+            _shift_default(idx);
 
             if (idx < _startup_end_index) {
                 ++_startup_end_index;
@@ -181,8 +317,10 @@ namespace mytho::ecs::internal {
 
             ASSURE(idx != schedule_index_null, "after-schedule not exist!");
 
-            _schedules.insert(_schedules.begin() + idx + 1, schedule_type(id, system_schedule_type()));
+            _schedules.insert(_schedules.begin() + idx + 1, schedule_type(id, _name<ScheduleE>(), system_schedule_type()));
             _graphs.insert(_graphs.begin() + idx + 1, system_graph_type());
+            _reindex(idx + 1);
+            _shift_default(idx + 1);
 
             if (idx < _startup_end_index) {
                 ++_startup_end_index;
@@ -205,16 +343,18 @@ namespace mytho::ecs::internal {
             auto insert_idx = _index(insert_id);
 
             if (insert_idx == schedule_index_null) {
-                _schedules.emplace_back(id, system_schedule_type());
+                _schedules.emplace_back(id, _name<ScheduleE>(), system_schedule_type());
                 _graphs.emplace_back();
+                _reindex(_schedules.size() - 1);
             } else {
+                // the new schedule takes the place of the old one, so the default index still points to it
+                _indices[insert_id] = schedule_index_null;
+
                 _schedules[insert_idx]._key = id;
+                _schedules[insert_idx]._name = _name<ScheduleE>();
                 _schedules[insert_idx]._schedule.clear();
                 _graphs[insert_idx].clear();
-
-                if (_default_index == insert_idx) {
-                    _default_index = idx;
-                }
+                _reindex(insert_idx);
             }
 
             return *this;
@@ -294,21 +434,58 @@ namespace mytho::ecs::internal {
             return *this;
         }
 
+        self_type& configure_set(system_set_type& set) {
+            ASSURE(_default_index < _schedules.size(), "no available default schedule!");
+
+            _graphs[_default_index].configure(set);
+
+            return *this;
+        }
+
+        template<auto ScheduleE>
+        self_type& configure_set(system_set_type& set) {
+            auto id = schedule_id_generator::template gen<ScheduleE>();
+            auto idx = _index(id);
+
+            ASSURE(idx != schedule_index_null, "schedule not exist!");
+
+            _graphs[idx].configure(set);
+
+            return *this;
+        }
+
+        template<typename ScheduleT>
+        self_type& configure_set(system_set_type& set) {
+            auto id = schedule_id_generator::template gen<ScheduleT>();
+            auto idx = _index(id);
+
+            ASSURE(idx != schedule_index_null, "schedule not exist!");
+
+            _graphs[idx].configure(set);
+
+            return *this;
+        }
+
     public:
-        void run(registry_type& reg, uint64_t& tick) {
-            auto size = _graphs.size();
-            for (auto i = 0; i < size; ++i) {
-                _schedules[i]._schedule = std::move(_graphs[i].sort());
+        // run the startup schedules, only the first call runs them
+        void startup(registry_type& reg, uint64_t& tick) {
+            if (_started) {
+                return;
             }
 
+            _started = true;
+
             for (auto i = 0; i < _startup_end_index; ++i) {
-                _schedules[i]._schedule.run(reg, tick);
+                _run(i, reg, tick);
             }
+        }
 
-            while(_running) {
-                for (auto i = _startup_end_index; i < _update_end_index; ++i) {
-                    _schedules[i]._schedule.run(reg, tick);
-                }
+        // run the update schedules once, the startup schedules are run first if they are not yet
+        void update(registry_type& reg, uint64_t& tick) {
+            startup(reg, tick);
+
+            for (auto i = _startup_end_index; i < _update_end_index; ++i) {
+                _run(i, reg, tick);
             }
         }
 
@@ -316,6 +493,80 @@ namespace mytho::ecs::internal {
             _running = false;
         }
 
+        bool running() const noexcept { return _running; }
+
+        bool started() const noexcept { return _started; }
+
+        // the number of threads running systems, 0 means the hardware concurrency, 1 runs systems one by one on the caller thread
+        void set_thread_count(size_type count, const affinity_type& affinity = {}) {
+            if (count == 0) {
+                count = std::max(1u, std::thread::hardware_concurrency());
+            }
+
+            // the old workers are joined before the new ones start, so the cores are never oversubscribed
+            _task_pool.reset();
+
+            if (count > 1) {
+                _task_pool = std::make_unique<task_pool_type>(count, affinity);
+            }
+        }
+
+        task_pool_type* task_pool() const noexcept { return _task_pool.get(); }
+
+        template<auto ScheduleE>
+        report_type report() {
+            auto idx = _index(schedule_id_generator::template gen<ScheduleE>());
+
+            ASSURE(idx != schedule_index_null, "schedule not exist!");
+
+            return _graphs[idx].report(_schedules[idx]._name);
+        }
+
+        template<typename ScheduleT>
+        report_type report() {
+            auto idx = _index(schedule_id_generator::template gen<ScheduleT>());
+
+            ASSURE(idx != schedule_index_null, "schedule not exist!");
+
+            return _graphs[idx].report(_schedules[idx]._name);
+        }
+
+        // the reports of all schedules in the order they are added, the startup and update schedules first
+        reports_type reports() {
+            reports_type reports;
+
+            for (schedule_index_type i = 0; i < _schedules.size(); ++i) {
+                reports.push_back(_graphs[i].report(_schedules[i]._name));
+            }
+
+            return reports;
+        }
+
+        // the system of the function address in any schedule, null if it is not added
+        meta_system_type* find_system(std::uintptr_t address) noexcept {
+            for (auto& graph : _graphs) {
+                if (auto system = graph.find(address)) {
+                    return system;
+                }
+            }
+
+            return nullptr;
+        }
+
+        // call `func(system)` for each system, schedule by schedule
+        template<typename FuncT>
+        void each_system(FuncT&& func) {
+            for (auto& graph : _graphs) {
+                graph.each(func);
+            }
+        }
+
+        void apply_commands(registry_type& reg, typename system_schedule_type::command_log_type* log) {
+            for (auto& schedule : _schedules) {
+                schedule._schedule.apply_commands(reg, log);
+            }
+        }
+
         template<auto ScheduleE>
         void run_schedule(registry_type& reg, uint64_t& tick) {
             auto id = schedule_id_generator::template gen<ScheduleE>();
@@ -323,7 +574,7 @@ namespace mytho::ecs::internal {
 
             ASSURE(idx != schedule_index_null, "new schedule already exists!");
 
-            _schedules[idx]._schedule.run(reg, tick);
+            _run(idx, reg, tick);
         }
 
         template<typename ScheduleT>
@@ -333,27 +584,71 @@ namespace mytho::ecs::internal {
 
             ASSURE(idx != schedule_index_null, "new schedule already exists!");
 
-            _schedules[idx]._schedule.run(reg, tick);
+            _run(idx, reg, tick);
         }
 
     private:
         bool _running = true;
+        bool _started = false;
         schedule_index_type _default_index = schedule_index_null;
         schedule_index_type _startup_end_index = 0;
         schedule_index_type _update_end_index = 0;
         schedules_type _schedules;
         graphs_type _graphs;
+        schedule_indices_type _indices;
+        condition_cache_type _conditions;
+        std::unique_ptr<task_pool_type> _task_pool;
 
     private:
+        // the systems added since the last run are sorted in, only the schedules with new systems are sorted again
+        void _run(schedule_index_type idx, registry_type& reg, uint64_t& tick) {
+            basic_trace_scope scope(reg.trace(), _schedules[idx]._name, "schedule");
+
+            auto& schedule = _schedules[idx]._schedule;
+            auto& graph = _graphs[idx];
+
+            if (graph.dirty()) {
+                schedule = graph.sort();
+
+                graph.each([this](auto& system) {
+                    system.bind_conditions(_conditions);
+                });
+            }
+
+            schedule.run(reg, tick, _task_pool.get());
+        }
+
+        // the names of schedules in traces
+        template<auto ScheduleE>
+        static constexpr std::string_view _name() noexcept { return mytho::core::value_name<ScheduleE>(); }
+
+        template<typename ScheduleT>
+        static constexpr std::string_view _name() noexcept { return mytho::core::type_name<ScheduleT>(); }
+
+        // schedule ids are dense, so the index of a schedule is looked up in a table indexed by id
         schedule_index_type _index(schedule_id_type id) const noexcept {
+            return id < _indices.size() ? _indices[id] : schedule_index_null;
+        }
+
+        // the schedules from `first` are added or moved by an insertion
+        // a schedule is inserted at `idx`, the default schedule moves with the schedules after it
+        void _shift_default(schedule_index_type idx) noexcept {
+            if (_default_index != schedule_index_null && idx <= _default_index) {
+                ++_default_index;
+            }
+        }
+
+        void _reindex(schedule_index_type first) {
             auto size = _schedules.size();
-            for (auto i = 0; i < size; ++i) {
-                if (_schedules[i]._key == id) {
-                    return i;
+            for (auto i = first; i < size; ++i) {
+                auto id = _schedules[i]._key;
+
+                if (id >= _indices.size()) {
+                    _indices.resize(id + 1, schedule_index_null);
                 }
-            }
 
-            return schedule_index_null;
+                _indices[id] = i;
+            }
         }
     };
 }
\ No newline at end of file
@@ -8,14 +8,27 @@
 #include <vector>
 #include <memory>
 #include <queue>
+#include <deque>
 #include <unordered_set>
 #include <unordered_map>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <tuple>
+#include <string_view>
 
 #include "core/assert.hpp"
+#include "core/idgen.hpp"
 #include "core/type_list.hpp"
-#include "storage/sparse_set.hpp"
+#include "core/type_hash.hpp"
 #include "ecs/commands.hpp"
 #include "ecs/core/event.hpp"
+#include "ecs/core/stats.hpp"
+#include "ecs/core/trace.hpp"
+#include "ecs/core/report.hpp"
+#include "ecs/core/coroutine.hpp"
+#include "ecs/core/pipeline.hpp"
 
 namespace mytho::ecs {
     // function traits
@@ -56,74 +69,567 @@ namespace mytho::ecs {
     template<typename T>
     using system_traits_t = typename internal::system_traits<T>::type;
 
+    // return traits
+    namespace internal {
+        template<typename T>
+        struct return_traits;
+
+        template<typename Ret, typename... Args>
+        struct return_traits<Ret(Args...)> {
+            using type = Ret;
+        };
+    }
+
+    template<typename T>
+    using return_traits_t = typename internal::return_traits<T>::type;
+
+    // system local data
+    namespace internal {
+        struct observer_genor final {};
+
+        // data owned by a system and kept between its runs
+        template<typename RegistryT>
+        class basic_system_local final {
+        public:
+            using registry_type = RegistryT;
+            using entity_type = typename registry_type::entity_type;
+            using component_id_generator = typename registry_type::component_id_generator;
+            using command_queue_type = typename registry_type::command_queue_type;
+            using observer_id_generator = mytho::core::basic_id_generator<observer_genor, size_t>;
+            using cursor_type = uint64_t;
+            using cursors_type = std::vector<cursor_type>;
+            using duration_type = std::chrono::nanoseconds;
+
+            struct observer_local {
+                static constexpr size_t id_null = std::numeric_limits<size_t>::max();
+
+                size_t id = id_null;
+                std::vector<entity_type> entities;
+            };
+
+            // deque keeps the references of the elements, the observers of the same system refer to them at once
+            using observer_locals_type = std::deque<observer_local>;
+
+        public:
+            template<typename T>
+            cursor_type& removed_cursor() {
+                auto id = component_id_generator::template gen<T>();
+
+                if (id >= _removed_cursors.size()) {
+                    _removed_cursors.resize(id + 1, 0);
+                }
+
+                return _removed_cursors[id];
+            }
+
+            template<typename FilterT>
+            observer_local& observer() {
+                auto id = observer_id_generator::template gen<FilterT>();
+
+                if (id >= _observers.size()) {
+                    _observers.resize(id + 1);
+                }
+
+                return _observers[id];
+            }
+
+            // commands recorded by the system, systems never share a queue so recording is contention free
+            command_queue_type& command_queue() noexcept {
+                return _command_queue;
+            }
+
+            // the suspended coroutine of a task system and the arguments it refers to, null between tasks
+            std::shared_ptr<void>& task() noexcept {
+                return _task;
+            }
+
+            // the time a task system may run in each run before `budget_exhausted` suspends it, zero for no limit
+            duration_type budget() const noexcept {
+                return _budget;
+            }
+
+            void set_budget(duration_type budget) noexcept {
+                _budget = budget;
+            }
+
+        #if MYTHO_PROFILE_ENABLED
+            // the entities matched by the queries of the current run, see `basic_system_stats::entities`
+            void count_entities(size_t count) noexcept {
+                _entities += count;
+            }
+
+            size_t take_entities() noexcept {
+                return std::exchange(_entities, 0);
+            }
+        #endif
+
+        private:
+            cursors_type _removed_cursors;
+            observer_locals_type _observers;
+            command_queue_type _command_queue;
+            std::shared_ptr<void> _task;
+            duration_type _budget = duration_type::zero();
+
+        #if MYTHO_PROFILE_ENABLED
+            size_t _entities = 0;
+        #endif
+        };
+    }
+
+    template<typename RegistryT>
+    using system_local_t = internal::basic_system_local<RegistryT>;
+
+    // system access
+    namespace internal {
+        // the components and resources a system reads and writes, systems whose accesses do not conflict can run concurrently
+        template<typename RegistryT>
+        class basic_system_access final {
+        public:
+            using registry_type = RegistryT;
+            using component_id_generator = typename registry_type::component_id_generator;
+            using resource_id_generator = typename registry_type::resource_id_generator;
+            using component_id_type = typename component_id_generator::value_type;
+            using resource_id_type = typename resource_id_generator::value_type;
+            using component_ids_type = std::vector<component_id_type>;
+            using resource_ids_type = std::vector<resource_id_type>;
+            using names_type = std::vector<std::string_view>;
+
+        public:
+            template<typename... Ts>
+            void read_components() {
+                (add(_component_reads, component_id<Ts>()), ...);
+            }
+
+            template<typename... Ts>
+            void write_components() {
+                (add(_component_writes, component_id<Ts>()), ...);
+            }
+
+            template<typename... Ts>
+            void read_resources() {
+                (add(_resource_reads, resource_id<Ts>()), ...);
+            }
+
+            template<typename... Ts>
+            void write_resources() {
+                (add(_resource_writes, resource_id<Ts>()), ...);
+            }
+
+            // an exclusive system conflicts with every system
+            void set_exclusive() noexcept {
+                _exclusive = true;
+            }
+
+            void merge(const basic_system_access& other) {
+                for (auto id : other._component_reads) add(_component_reads, id);
+                for (auto id : other._component_writes) add(_component_writes, id);
+                for (auto id : other._resource_reads) add(_resource_reads, id);
+                for (auto id : other._resource_writes) add(_resource_writes, id);
+
+                _exclusive = _exclusive || other._exclusive;
+            }
+
+            // two systems conflict if one of them writes data the other one reads or writes
+            bool conflict(const basic_system_access& other) const noexcept {
+                if (_exclusive || other._exclusive) {
+                    return true;
+                }
+
+                return intersect(_component_writes, other._component_reads) || intersect(_component_writes, other._component_writes)
+                    || intersect(other._component_writes, _component_reads)
+                    || intersect(_resource_writes, other._resource_reads) || intersect(_resource_writes, other._resource_writes)
+                    || intersect(other._resource_writes, _resource_reads);
+            }
+
+            // the data both systems access while at least one of them writes it, appended to `components` and `resources`
+            void conflicts(const basic_system_access& other, component_ids_type& components, resource_ids_type& resources) const {
+                intersection(_component_writes, other._component_reads, components);
+                intersection(_component_writes, other._component_writes, components);
+                intersection(other._component_writes, _component_reads, components);
+                intersection(_resource_writes, other._resource_reads, resources);
+                intersection(_resource_writes, other._resource_writes, resources);
+                intersection(other._resource_writes, _resource_reads, resources);
+            }
+
+            // the type names of the ids, recorded as the accesses are collected
+            static std::string_view component_name(component_id_type id) noexcept {
+                return id < _component_names.size() ? _component_names[id] : std::string_view{};
+            }
+
+            static std::string_view resource_name(resource_id_type id) noexcept {
+                return id < _resource_names.size() ? _resource_names[id] : std::string_view{};
+            }
+
+        public:
+            const component_ids_type& component_reads() const noexcept { return _component_reads; }
+
+            const component_ids_type& component_writes() const noexcept { return _component_writes; }
+
+            const resource_ids_type& resource_reads() const noexcept { return _resource_reads; }
+
+            const resource_ids_type& resource_writes() const noexcept { return _resource_writes; }
+
+            bool exclusive() const noexcept { return _exclusive; }
+
+        private:
+            component_ids_type _component_reads;
+            component_ids_type _component_writes;
+            resource_ids_type _resource_reads;
+            resource_ids_type _resource_writes;
+            bool _exclusive = false;
+
+            inline static names_type _component_names;
+            inline static names_type _resource_names;
+
+        private:
+            template<typename T>
+            static component_id_type component_id() {
+                auto id = component_id_generator::template gen<T>();
+                name(_component_names, id, mytho::core::type_name<T>());
+
+                return id;
+            }
+
+            template<typename T>
+            static resource_id_type resource_id() {
+                auto id = resource_id_generator::template gen<T>();
+                name(_resource_names, id, mytho::core::type_name<T>());
+
+                return id;
+            }
+
+            template<typename IdT>
+            static void name(names_type& names, IdT id, std::string_view name) {
+                if (id >= names.size()) {
+                    names.resize(id + 1);
+                }
+
+                names[id] = name;
+            }
+
+            template<typename IdsT>
+            static void intersection(const IdsT& l, const IdsT& r, IdsT& result) {
+                for (auto id : l) {
+                    if (std::find(r.begin(), r.end(), id) != r.end()) {
+                        add(result, id);
+                    }
+                }
+            }
+
+            template<typename IdsT, typename IdT>
+            static void add(IdsT& ids, IdT id) {
+                if (std::find(ids.begin(), ids.end(), id) == ids.end()) {
+                    ids.push_back(id);
+                }
+            }
+
+            // the id lists of a system are short, a linear scan is cheaper than hashing
+            template<typename IdsT>
+            static bool intersect(const IdsT& l, const IdsT& r) noexcept {
+                for (auto id : l) {
+                    if (std::find(r.begin(), r.end(), id) != r.end()) {
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+        };
+    }
+
+    template<typename RegistryT>
+    using system_access_t = internal::basic_system_access<RegistryT>;
+
     // argument constructors
     template<typename RegistryT, typename ArgumentT>
     struct constructor;
 
+    // the system changes the registry directly, see the access below
+    template<typename RegistryT>
+    struct constructor<RegistryT, RegistryT&> {
+        RegistryT& operator()(RegistryT& reg, uint64_t tick, system_local_t<RegistryT>& local) const noexcept {
+            return reg;
+        }
+    };
+
     template<typename RegistryT>
     struct constructor<RegistryT, basic_commands<RegistryT>> {
-        auto operator()(RegistryT& reg, uint64_t tick) const noexcept {
-            return basic_commands(reg, tick);
+        auto operator()(RegistryT& reg, uint64_t tick, system_local_t<RegistryT>& local) const noexcept {
+            return basic_commands(reg, tick, local.command_queue());
         }
     };
 
     template<typename RegistryT, typename... Ts>
     struct constructor<RegistryT, basic_querier<RegistryT, Ts...>> {
-        auto operator()(RegistryT& reg, uint64_t tick) const {
-            return reg.template query<Ts...>(tick);
+        auto operator()(RegistryT& reg, uint64_t tick, system_local_t<RegistryT>& local) const {
+            auto querier = reg.template query<Ts...>(tick);
+
+        #if MYTHO_PROFILE_ENABLED
+            local.count_entities(querier.size());
+        #endif
+
+            return querier;
         }
     };
 
     template<typename RegistryT, typename... Ts>
     struct constructor<RegistryT, basic_resources<Ts...>> {
-        auto operator()(RegistryT& reg, uint64_t tick) const noexcept {
+        auto operator()(RegistryT& reg, uint64_t tick, system_local_t<RegistryT>& local) const noexcept {
             return reg.template resources<Ts...>();
         }
     };
 
     template<typename RegistryT, typename... Ts>
     struct constructor<RegistryT, basic_resources_mut<Ts...>> {
-        auto operator()(RegistryT& reg, uint64_t tick) const noexcept {
+        auto operator()(RegistryT& reg, uint64_t tick, system_local_t<RegistryT>& local) const noexcept {
             return reg.template resources_mut<Ts...>();
         }
     };
 
     template<typename RegistryT, typename T>
     struct constructor<RegistryT, basic_event_writer<T>> {
-        auto operator()(RegistryT& reg, uint64_t tick) const noexcept {
+        auto operator()(RegistryT& reg, uint64_t tick, system_local_t<RegistryT>& local) const noexcept {
             return basic_event_writer<T>(reg.template event_write<T>());
         }
     };
 
     template<typename RegistryT, typename T>
     struct constructor<RegistryT, basic_event_mutator<T>> {
-        auto operator()(RegistryT& reg, uint64_t tick) const noexcept {
+        auto operator()(RegistryT& reg, uint64_t tick, system_local_t<RegistryT>& local) const noexcept {
             return basic_event_mutator<T>(reg.template event_mutate<T>());
         }
     };
 
     template<typename RegistryT, typename T>
     struct constructor<RegistryT, basic_event_reader<T>> {
-        auto operator()(RegistryT& reg, uint64_t tick) const noexcept {
+        auto operator()(RegistryT& reg, uint64_t tick, system_local_t<RegistryT>& local) const noexcept {
             return basic_event_reader<T>(reg.template event_read<T>());
         }
     };
 
     template<typename RegistryT, typename T>
     struct constructor<RegistryT, basic_removed_entities<RegistryT, T>> {
-        auto operator()(RegistryT& reg, uint64_t tick) const noexcept {
-            return basic_removed_entities<RegistryT, T>(reg.template removed_entities<T>());
+        auto operator()(RegistryT& reg, uint64_t tick, system_local_t<RegistryT>& local) const noexcept {
+            return basic_removed_entities<RegistryT, T>(reg.template removed_entities<T>(), local.template removed_cursor<T>());
+        }
+    };
+
+    template<typename RegistryT, typename FilterT>
+    struct constructor<RegistryT, basic_observer<RegistryT, FilterT>> {
+        auto operator()(RegistryT& reg, uint64_t tick, system_local_t<RegistryT>& local) const {
+            auto& observer = local.template observer<FilterT>();
+
+            // the observer is created at the first run of the system
+            if (observer.id == observer.id_null) {
+                observer.id = reg.template observe<FilterT>();
+            }
+
+            reg.template observed<FilterT>(observer.id, tick, observer.entities);
+
+            return basic_observer<RegistryT, FilterT>(observer.entities);
+        }
+    };
+
+    template<typename RegistryT>
+    struct constructor<RegistryT, basic_extract<RegistryT>> {
+        auto operator()(RegistryT& reg, uint64_t tick, system_local_t<RegistryT>& local) const noexcept {
+            return basic_extract<RegistryT>(reg.sub_registry());
+        }
+    };
+
+    // argument accesses, collected from the argument types at compile time
+    template<typename RegistryT, typename ArgumentT>
+    struct access;
+
+    // the registry may be changed in any way, e.g. applying commands or running schedules, so the system is exclusive
+    template<typename RegistryT>
+    struct access<RegistryT, RegistryT&> {
+        static void collect(system_access_t<RegistryT>& access) noexcept {
+            access.set_exclusive();
+        }
+    };
+
+    // commands are deferred, so they access nothing while the system runs
+    template<typename RegistryT>
+    struct access<RegistryT, basic_commands<RegistryT>> {
+        static void collect(system_access_t<RegistryT>& access) noexcept {}
+    };
+
+    namespace internal {
+        template<typename RegistryT, typename T>
+        struct query_value_access {
+            static void collect(system_access_t<RegistryT>& access) {
+                if constexpr (!std::is_same_v<T, typename RegistryT::entity_type>) {
+                    access.template read_components<T>();
+                }
+            }
+        };
+
+        template<typename RegistryT, typename... Ts>
+        struct query_value_access<RegistryT, mut<Ts...>> {
+            static void collect(system_access_t<RegistryT>& access) {
+                access.template write_components<Ts...>();
+            }
+        };
+
+        // with/without only check the existence of components, which is changed by applying commands only
+        template<typename RegistryT, typename... Ts>
+        struct query_value_access<RegistryT, with<Ts...>> {
+            static void collect(system_access_t<RegistryT>& access) noexcept {}
+        };
+
+        template<typename RegistryT, typename... Ts>
+        struct query_value_access<RegistryT, without<Ts...>> {
+            static void collect(system_access_t<RegistryT>& access) noexcept {}
+        };
+
+        template<typename RegistryT, typename... Ts>
+        struct query_value_access<RegistryT, added<Ts...>> {
+            static void collect(system_access_t<RegistryT>& access) {
+                access.template read_components<Ts...>();
+            }
+        };
+
+        template<typename RegistryT, typename... Ts>
+        struct query_value_access<RegistryT, changed<Ts...>> {
+            static void collect(system_access_t<RegistryT>& access) {
+                access.template read_components<Ts...>();
+            }
+        };
+    }
+
+    template<typename RegistryT, typename... Ts>
+    struct access<RegistryT, basic_querier<RegistryT, Ts...>> {
+        static void collect(system_access_t<RegistryT>& access) {
+            (internal::query_value_access<RegistryT, Ts>::collect(access), ...);
+        }
+    };
+
+    template<typename RegistryT, typename... Ts>
+    struct access<RegistryT, basic_resources<Ts...>> {
+        static void collect(system_access_t<RegistryT>& access) {
+            access.template read_resources<Ts...>();
+        }
+    };
+
+    template<typename RegistryT, typename... Ts>
+    struct access<RegistryT, basic_resources_mut<Ts...>> {
+        static void collect(system_access_t<RegistryT>& access) {
+            access.template write_resources<Ts...>();
+        }
+    };
+
+    template<typename RegistryT, typename T>
+    struct access<RegistryT, basic_event_writer<T>> {
+        static void collect(system_access_t<RegistryT>& access) {
+            access.template write_resources<typename RegistryT::template events_type<T>>();
+        }
+    };
+
+    template<typename RegistryT, typename T>
+    struct access<RegistryT, basic_event_mutator<T>> {
+        static void collect(system_access_t<RegistryT>& access) {
+            access.template write_resources<typename RegistryT::template events_type<T>>();
+        }
+    };
+
+    template<typename RegistryT, typename T>
+    struct access<RegistryT, basic_event_reader<T>> {
+        static void collect(system_access_t<RegistryT>& access) {
+            access.template read_resources<typename RegistryT::template events_type<T>>();
         }
     };
 
+    template<typename RegistryT, typename T>
+    struct access<RegistryT, basic_removed_entities<RegistryT, T>> {
+        static void collect(system_access_t<RegistryT>& access) {
+            access.template read_components<T>();
+        }
+    };
+
+    // the observer is registered into the component storage at the first run, which changes the storage structure
+    template<typename RegistryT, typename FilterT>
+    struct access<RegistryT, basic_observer<RegistryT, FilterT>> {
+        static void collect(system_access_t<RegistryT>& access) noexcept {
+            access.set_exclusive();
+        }
+    };
+
+    // the sub-registry is written as a whole, the extract systems take turns
+    template<typename RegistryT>
+    struct access<RegistryT, basic_extract<RegistryT>> {
+        static void collect(system_access_t<RegistryT>& access) {
+            access.template write_resources<basic_extract<RegistryT>>();
+        }
+    };
+
+    namespace internal {
+        // the parameters of a task system are references to the arguments, the registry is always one
+        template<typename RegistryT, typename T>
+        using argument_t = std::conditional_t<std::is_same_v<T, RegistryT&>, T, std::remove_cvref_t<T>>;
+
+        // the arguments of a task system, kept in place between its runs
+        template<typename RegistryT, typename... Ts>
+        struct task_state {
+            std::optional<std::tuple<argument_t<RegistryT, Ts>...>> arguments;
+            basic_system_task task;
+        };
+
+        template<typename RegistryT, typename... Ts>
+        void collect_access(system_access_t<RegistryT>& access, type_list<Ts...>) {
+            using local_type = system_local_t<RegistryT>;
+
+            // the functions taking the raw arguments, e.g. the combined run conditions, may touch anything
+            if constexpr (std::is_same_v<type_list<Ts...>, type_list<RegistryT&, uint64_t, local_type&>>) {
+                access.set_exclusive();
+            } else {
+                (mytho::ecs::access<RegistryT, argument_t<RegistryT, Ts>>::collect(access), ...);
+            }
+        }
+
+        template<typename RegistryT, typename Fp>
+        auto access_collector_construct() noexcept {
+            return [](system_access_t<RegistryT>& access) {
+                collect_access<RegistryT>(access, system_traits_t<function_traits_t<Fp>>{});
+            };
+        }
+
+        // the arguments a memoized run condition may take, its result depends on nothing else
+        template<typename RegistryT, typename T>
+        struct pure_input : std::false_type {};
+
+        template<typename RegistryT, typename... Ts>
+        struct pure_input<RegistryT, basic_resources<Ts...>> : std::true_type {
+            static uint64_t changed_tick(RegistryT& reg) noexcept {
+                return reg.template resources_changed_tick<Ts...>();
+            }
+        };
+
+        // the last tick the inputs changed at, null if the function takes anything but read only resources
+        template<typename RegistryT, typename... Ts>
+        auto inputs_tick_construct(type_list<Ts...>) noexcept -> uint64_t(*)(RegistryT&) {
+            if constexpr (sizeof...(Ts) > 0 && (pure_input<RegistryT, Ts>::value && ...)) {
+                return [](RegistryT& reg) {
+                    return std::max({ pure_input<RegistryT, Ts>::changed_tick(reg)... });
+                };
+            } else {
+                return nullptr;
+            }
+        }
+    }
+
     template<typename RegistryT, typename ReturnT>
     class basic_function final {
     public:
         using registry_type = RegistryT;
         using return_type = ReturnT;
-        using function_wrapper_type = return_type(*)(std::uintptr_t, registry_type&, uint64_t);
+        using local_type = system_local_t<registry_type>;
+        using function_wrapper_type = return_type(*)(std::uintptr_t, registry_type&, uint64_t, local_type&);
+        using access_type = system_access_t<registry_type>;
+        using access_collector_type = void(*)(access_type&);
+        using inputs_tick_type = uint64_t(*)(registry_type&);
 
-        basic_function() noexcept : _function_wrapper(nullptr), _address(0) {}
+        basic_function() noexcept : _function_wrapper(nullptr), _access_collector(nullptr), _inputs_tick(nullptr), _address(0) {}
 
         template<mytho::core::FunctionType Func>
         basic_function(Func&& func) noexcept {
@@ -132,175 +638,587 @@ namespace mytho::ecs {
             Fp fp = +func;
             _address = std::bit_cast<std::uintptr_t>(fp);
             _function_wrapper = function_wrapper_construct<Fp>();
+            _access_collector = internal::access_collector_construct<registry_type, Fp>();
+            _inputs_tick = internal::inputs_tick_construct<registry_type>(system_traits_t<function_traits_t<Fp>>{});
         }
 
     public:
-        return_type operator()(registry_type& reg, uint64_t tick) {
-            return _function_wrapper(_address, reg, tick);
+        return_type operator()(registry_type& reg, uint64_t tick, local_type& local) {
+            return _function_wrapper(_address, reg, tick, local);
+        }
+
+        void collect_access(access_type& access) const {
+            if (_access_collector) {
+                _access_collector(access);
+            }
         }
 
     public:
         std::uintptr_t address() const noexcept { return _address; }
 
+        // whether the function only reads resources, so its result only changes when they change
+        bool pure() const noexcept { return _inputs_tick; }
+
+        // the last tick the resources read changed at, the function must be pure
+        uint64_t inputs_tick(registry_type& reg) const noexcept { return _inputs_tick(reg); }
+
     private:
         function_wrapper_type _function_wrapper;
+        access_collector_type _access_collector;
+        inputs_tick_type _inputs_tick;
         std::uintptr_t _address;
 
     private:
         template<typename Fp>
         auto function_wrapper_construct() noexcept {
-            return [](std::uintptr_t addr, registry_type& reg, uint64_t tick) -> return_type {
+            return [](std::uintptr_t addr, registry_type& reg, uint64_t tick, local_type& local) -> return_type {
                 using types = system_traits_t<function_traits_t<Fp>>;
 
-                if constexpr (std::is_same_v<types, mytho::core::type_list<registry_type&, uint64_t>>) {
-                    return function_invoke(std::bit_cast<Fp>(addr), reg, tick);
+                if constexpr (std::is_same_v<types, mytho::core::type_list<registry_type&, uint64_t, local_type&>>) {
+                    return function_invoke(std::bit_cast<Fp>(addr), reg, tick, local);
                 } else {
-                    return function_invoke(std::bit_cast<Fp>(addr), reg, tick, types{});
+                    return function_invoke(std::bit_cast<Fp>(addr), reg, tick, local, types{});
                 }
             };
         }
 
         template<typename Func, typename T, typename... Rs>
-        static return_type function_invoke(Func&& func, registry_type& reg, uint64_t tick, mytho::core::type_list<T, Rs...>) {
-            return std::invoke(std::forward<Func>(func), constructor<registry_type, T>{}(reg, tick), constructor<registry_type, Rs>{}(reg, tick)...);
+        static return_type function_invoke(Func&& func, registry_type& reg, uint64_t tick, local_type& local, mytho::core::type_list<T, Rs...>) {
+            return std::invoke(std::forward<Func>(func), constructor<registry_type, T>{}(reg, tick, local), constructor<registry_type, Rs>{}(reg, tick, local)...);
+        }
+
+        template<typename Func>
+        static return_type function_invoke(Func&& func, registry_type& reg, uint64_t tick, local_type& local) {
+            return std::invoke(std::forward<Func>(func), reg, tick, local);
+        }
+    };
+
+    template<typename RegistryT>
+    class basic_function<RegistryT, void> final {
+    public:
+        using registry_type = RegistryT;
+        using local_type = system_local_t<registry_type>;
+        using function_wrapper_type = void(*)(std::uintptr_t, registry_type&, uint64_t, local_type&);
+        using access_type = system_access_t<registry_type>;
+        using access_collector_type = void(*)(access_type&);
+
+        basic_function() noexcept : _function_wrapper(nullptr), _access_collector(nullptr), _address(0) {}
+
+        template<mytho::core::FunctionType Func>
+        basic_function(Func&& func) noexcept {
+            using Fp = decltype(+std::declval<Func>());
+
+            Fp fp = +func;
+            _address = std::bit_cast<std::uintptr_t>(fp);
+            _function_wrapper = function_wrapper_construct<Fp>();
+            _access_collector = internal::access_collector_construct<registry_type, Fp>();
+        }
+
+    public:
+        void operator()(registry_type& reg, uint64_t tick, local_type& local) const {
+            _function_wrapper(_address, reg, tick, local);
+        }
+
+        void collect_access(access_type& access) const {
+            if (_access_collector) {
+                _access_collector(access);
+            }
+        }
+
+    public:
+        std::uintptr_t address() const noexcept { return _address; }
+
+    private:
+        function_wrapper_type _function_wrapper;
+        access_collector_type _access_collector;
+        std::uintptr_t _address;
+
+    private:
+        template<typename Fp>
+        auto function_wrapper_construct() noexcept {
+            return [](std::uintptr_t addr, registry_type& reg, uint64_t tick, local_type& local) {
+                using types = system_traits_t<function_traits_t<Fp>>;
+
+                if constexpr (std::is_same_v<return_traits_t<function_traits_t<Fp>>, basic_system_task>) {
+                    task_invoke(std::bit_cast<Fp>(addr), reg, tick, local, types{});
+                } else {
+                    function_invoke(std::bit_cast<Fp>(addr), reg, tick, local, types{});
+                }
+            };
+        }
+
+        template<typename Func, typename... Ts>
+        static void function_invoke(Func&& func, registry_type& reg, uint64_t tick, local_type& local, mytho::core::type_list<Ts...>) {
+            std::invoke(std::forward<Func>(func), constructor<registry_type, Ts>{}(reg, tick, local)...);
+        }
+
+        // start the task if none is suspended, or rebind the arguments it refers to, then resume it
+        template<typename Func, typename... Ts>
+        static void task_invoke(Func func, registry_type& reg, uint64_t tick, local_type& local, mytho::core::type_list<Ts...>) {
+            static_assert((std::is_lvalue_reference_v<Ts> && ...), "task system parameters must be references");
+
+            using state_type = internal::task_state<registry_type, Ts...>;
+
+            auto& slot = local.task();
+            if (!slot) {
+                slot = std::make_shared<state_type>();
+            }
+
+            auto& state = *static_cast<state_type*>(slot.get());
+
+            // the new arguments take the place of the old ones, so the references in the coroutine frame stay valid
+            state.arguments.emplace(constructor<registry_type, internal::argument_t<registry_type, Ts>>{}(reg, tick, local)...);
+
+            if (!state.task.valid()) {
+                state.task = std::apply(func, *state.arguments);
+            }
+
+            if (state.task.resume(local.budget())) {
+                slot.reset();
+            }
+        }
+    };
+
+    template<typename RegistryT, auto... Funcs>
+    constexpr auto all_of() {
+        using registry_type = RegistryT;
+        using condition_type = basic_function<registry_type, bool>;
+
+        return [](registry_type& reg, uint64_t tick, system_local_t<registry_type>& local) {
+            return (condition_type{Funcs}(reg, tick, local) && ...);
+        };
+    }
+
+    template<typename RegistryT, auto... Funcs>
+    constexpr auto any_of() {
+        using registry_type = RegistryT;
+        using condition_type = basic_function<registry_type, bool>;
+
+        return [](registry_type& reg, uint64_t tick, system_local_t<registry_type>& local) {
+            return (condition_type{Funcs}(reg, tick, local) || ...);
+        };
+    }
+
+    template<typename RegistryT, auto Func>
+    constexpr auto not_of() {
+        using registry_type = RegistryT;
+        using condition_type = basic_function<registry_type, bool>;
+
+        return [](registry_type& reg, uint64_t tick, system_local_t<registry_type>& local) {
+            return !condition_type{Func}(reg, tick, local);
+        };
+    }
+}
+
+namespace mytho::ecs::internal {
+    // a system set is identified by the address of its tag, which is never the address of a system function
+    template<auto SetE>
+    struct value_set_tag { inline static char tag = 0; };
+
+    template<typename SetT>
+    struct type_set_tag { inline static char tag = 0; };
+
+    template<auto SetE>
+    std::uintptr_t set_key() noexcept { return std::bit_cast<std::uintptr_t>(&value_set_tag<SetE>::tag); }
+
+    template<typename SetT>
+    std::uintptr_t set_key() noexcept { return std::bit_cast<std::uintptr_t>(&type_set_tag<SetT>::tag); }
+
+    /*
+     * the results of the pure run conditions, shared by all systems of a registry and keyed by the condition address,
+     * so a condition shared by many systems is evaluated once until the resources it reads change.
+     * an entry holds `(tick << 1) | result`, the tick is the registry tick at the evaluation, 0 if not evaluated.
+     * the entries are created while the schedules are sorted, the systems of a wave only load and store them.
+     */
+    template<typename RegistryT>
+    class basic_condition_cache final {
+    public:
+        using registry_type = RegistryT;
+        using entry_type = std::atomic<uint64_t>;
+        using runif_type = basic_function<registry_type, bool>;
+
+    public:
+        // the entry of the condition, null if it is not pure
+        entry_type* entry(const runif_type& runif) {
+            return runif.address() && runif.pure() ? &_entries[runif.address()] : nullptr;
+        }
+
+        // evaluate the condition, or take the result of its last evaluation if the resources it reads did not change since
+        template<typename FuncT>
+        inline static bool evaluate(entry_type& entry, const runif_type& runif, registry_type& reg, FuncT&& func) {
+            auto tick = reg.current_tick();
+            auto state = entry.load(std::memory_order_relaxed);
+
+            if (state != 0 && runif.inputs_tick(reg) < (state >> 1)) {
+                return state & 1;
+            }
+
+            bool result = func();
+            entry.store((tick << 1) | uint64_t(result), std::memory_order_relaxed);
+
+            return result;
+        }
+
+        void clear() noexcept {
+            for (auto& [address, entry] : _entries) {
+                entry.store(0, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        std::unordered_map<std::uintptr_t, entry_type> _entries;
+    };
+
+    template<typename RegistryT>
+    class basic_meta_system final {
+    public:
+        using registry_type = RegistryT;
+        using self_type = basic_meta_system<registry_type>;
+        using tick_type = uint64_t;
+        using function_type = basic_function<registry_type, void>;
+        using runif_type = basic_function<registry_type, bool>;
+        using runifs_type = std::vector<runif_type>;
+        using local_type = system_local_t<registry_type>;
+        using access_type = system_access_t<registry_type>;
+        using stats_type = basic_system_stats;
+        using duration_type = typename local_type::duration_type;
+        using condition_cache_type = basic_condition_cache<registry_type>;
+        using condition_entries_type = std::vector<typename condition_cache_type::entry_type*>;
+        using set_results_type = std::vector<const bool*>;
+
+    public:
+        basic_meta_system() noexcept = default;
+
+        template<mytho::core::FunctionType Func>
+        basic_meta_system(Func&& func)
+            : _function(std::forward<Func>(func)), _runifs(), _last_run_tick(0) {
+            _function.collect_access(_access);
+        }
+
+        basic_meta_system(function_type&& func, runifs_type&& runifs, bool exclusive = false, bool main_thread = false,
+            std::string_view name = {}, duration_type budget = duration_type::zero(), tick_type tick = 0)
+            : _function(func), _runifs(std::move(runifs)), _last_run_tick(tick), _name(name), _main_thread(main_thread) {
+            _local.set_budget(budget);
+
+            // the run conditions are evaluated with the system, so their accesses belong to the system
+            _function.collect_access(_access);
+            for (auto& runif : _runifs) {
+                runif.collect_access(_access);
+            }
+
+            if (exclusive) {
+                _access.set_exclusive();
+            }
+        }
+
+        // the system of a system set, it runs no function but evaluates the run conditions of the set into `result`
+        basic_meta_system(runifs_type&& runifs, bool* result, std::string_view name)
+            : _runifs(std::move(runifs)), _name(name), _set_result(result) {
+            for (auto& runif : _runifs) {
+                runif.collect_access(_access);
+            }
+        }
+
+    public:
+        void operator()(registry_type& reg, uint64_t tick) {
+            basic_trace_scope scope(reg.trace(), name(), "system", _function.address());
+
+        #if MYTHO_PROFILE_ENABLED
+            auto begin = stats_type::clock_type::now();
+        #endif
+
+            if (!conditions(reg)) {
+                if (_set_result) {
+                    *_set_result = false;
+                }
+
+            #if MYTHO_PROFILE_ENABLED
+                _local.take_entities();
+                _stats.skip();
+            #endif
+
+                return;
+            }
+
+            if (_set_result) {
+                *_set_result = true;
+            } else {
+                _function(reg, _last_run_tick, _local);
+            }
+
+            _last_run_tick = tick;
+
+        #if MYTHO_PROFILE_ENABLED
+            _stats.record(stats_type::clock_type::now() - begin, _local.take_entities());
+        #endif
+        }
+
+        void apply_commands(registry_type& reg, typename registry_type::command_log_type* log) {
+            _local.command_queue().apply(reg, log);
+        }
+
+        // share the results of the pure run conditions through the cache, until bound they are evaluated on each run
+        void bind_conditions(condition_cache_type& cache) {
+            _conditions.resize(_runifs.size());
+
+            for (size_t i = 0; i < _runifs.size(); ++i) {
+                _conditions[i] = cache.entry(_runifs[i]);
+            }
+        }
+
+        // the results of the run conditions of the sets the system is in, they are evaluated before the system runs
+        void bind_sets(set_results_type&& sets) noexcept {
+            _sets = std::move(sets);
+        }
+
+    public:
+        const access_type& access() const noexcept { return _access; }
+
+        std::uintptr_t address() const noexcept { return _function.address(); }
+
+        std::string_view name() const noexcept { return _name.empty() ? "system" : _name; }
+
+        bool main_thread() const noexcept { return _main_thread; }
+
+    #if MYTHO_PROFILE_ENABLED
+        const stats_type& stats() const noexcept { return _stats; }
+
+        void reset_stats() noexcept { _stats.reset(); }
+    #endif
+
+    private:
+        tick_type _last_run_tick = 0;
+        function_type _function{};
+        runifs_type _runifs{};
+        local_type _local{};
+        access_type _access{};
+        std::string_view _name{};
+        condition_entries_type _conditions{};
+        set_results_type _sets{};
+        bool* _set_result = nullptr;
+        bool _main_thread = false;
+
+    #if MYTHO_PROFILE_ENABLED
+        stats_type _stats{};
+    #endif
+
+    private:
+        bool conditions(registry_type& reg) {
+            for (auto set : _sets) {
+                if (!*set) {
+                    return false;
+                }
+            }
+
+            for (size_t i = 0; i < _runifs.size(); ++i) {
+                if (_runifs[i].address() && !condition(i, reg)) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        bool condition(size_t i, registry_type& reg) {
+            auto& runif = _runifs[i];
+            auto entry = i < _conditions.size() ? _conditions[i] : nullptr;
+
+            if (!entry) {
+                return runif(reg, _last_run_tick, _local);
+            }
+
+            return condition_cache_type::evaluate(*entry, runif, reg, [&]() {
+                return runif(reg, _last_run_tick, _local);
+            });
+        }
+    };
+
+    template<typename RegistryT>
+    class basic_system final {
+    public:
+        using registry_type = RegistryT;
+        using self_type = basic_system<registry_type>;
+        using function_type = basic_function<registry_type, void>;
+        using runif_type = basic_function<registry_type, bool>;
+        using runifs_type = std::vector<runif_type>;
+        using befores_type = std::vector<std::uintptr_t>;
+        using afters_type = std::vector<std::uintptr_t>;
+        using sets_type = std::vector<std::uintptr_t>;
+        using duration_type = std::chrono::nanoseconds;
+
+        basic_system() noexcept = default;
+
+        template<mytho::core::FunctionType Func>
+        basic_system(Func&& func) noexcept : _function(std::forward<Func>(func)) {}
+
+    public:
+        template<mytho::core::FunctionType Func>
+        self_type& after(Func&& func) {
+            using Fp = decltype(+std::declval<Func>());
+
+            Fp fp = +func;
+            _afters.push_back(std::bit_cast<std::uintptr_t>(fp));
+
+            return *this;
+        }
+
+        // run after all systems of the set
+        template<auto SetE>
+        self_type& after() {
+            _afters.push_back(set_key<SetE>());
+
+            return *this;
+        }
+
+        template<typename SetT>
+        self_type& after() {
+            _afters.push_back(set_key<SetT>());
+
+            return *this;
+        }
+
+        template<mytho::core::FunctionType Func>
+        self_type& before(Func&& func) {
+            using Fp = decltype(+std::declval<Func>());
+
+            Fp fp = +func;
+            _befores.push_back(std::bit_cast<std::uintptr_t>(fp));
+
+            return *this;
+        }
+
+        // run before all systems of the set
+        template<auto SetE>
+        self_type& before() {
+            _befores.push_back(set_key<SetE>());
+
+            return *this;
         }
 
-        template<typename Func>
-        static return_type function_invoke(Func&& func, registry_type& reg, uint64_t tick) {
-            return std::invoke(std::forward<Func>(func), reg, tick);
+        template<typename SetT>
+        self_type& before() {
+            _befores.push_back(set_key<SetT>());
+
+            return *this;
         }
-    };
 
-    template<typename RegistryT>
-    class basic_function<RegistryT, void> final {
-    public:
-        using registry_type = RegistryT;
-        using function_wrapper_type = void(*)(std::uintptr_t, registry_type&, uint64_t);
+        // the ordering and run conditions of the set, configured by `basic_system_set`, apply to the system
+        template<auto SetE>
+        self_type& in_set() {
+            _sets.push_back(set_key<SetE>());
 
-        basic_function() noexcept : _function_wrapper(nullptr), _address(0) {}
+            return *this;
+        }
 
-        template<mytho::core::FunctionType Func>
-        basic_function(Func&& func) noexcept {
-            using Fp = decltype(+std::declval<Func>());
+        template<typename SetT>
+        self_type& in_set() {
+            _sets.push_back(set_key<SetT>());
 
-            Fp fp = +func;
-            _address = std::bit_cast<std::uintptr_t>(fp);
-            _function_wrapper = function_wrapper_construct<Fp>();
+            return *this;
         }
 
-    public:
-        void operator()(registry_type& reg, uint64_t tick) const {
-            _function_wrapper(_address, reg, tick);
+        template<mytho::core::FunctionType Func>
+        self_type& runif(Func&& func) noexcept {
+            _runifs.emplace_back(std::forward<Func>(func));
+
+            return *this;
         }
 
-    public:
-        std::uintptr_t address() const noexcept { return _address; }
+        /*
+         * the system never runs concurrently with other systems, e.g. it changes the registry structure directly.
+         * the systems taking the registry, e.g. `void f(Registry& reg)`, or observers are exclusive without it.
+         */
+        self_type& exclusive() noexcept {
+            _exclusive = true;
 
-    private:
-        function_wrapper_type _function_wrapper;
-        std::uintptr_t _address;
+            return *this;
+        }
 
-    private:
-        template<typename Fp>
-        auto function_wrapper_construct() noexcept {
-            return [](std::uintptr_t addr, registry_type& reg, uint64_t tick) {
-                using types = system_traits_t<function_traits_t<Fp>>;
+        // the system runs on the thread calling `update`, e.g. it calls an api bound to that thread, other systems may run meanwhile
+        self_type& main_thread() noexcept {
+            _main_thread = true;
 
-                function_invoke(std::bit_cast<Fp>(addr), reg, tick, types{});
-            };
+            return *this;
         }
 
-        template<typename Func, typename... Ts>
-        static void function_invoke(Func&& func, registry_type& reg, uint64_t tick, mytho::core::type_list<Ts...>) {
-            std::invoke(std::forward<Func>(func), constructor<registry_type, Ts>{}(reg, tick)...);
-        }
-    };
+        // the name in traces, it is not copied, so it must outlive the registry, e.g. a string literal
+        self_type& name(std::string_view name) noexcept {
+            _name = name;
 
-    template<typename RegistryT, auto... Funcs>
-    constexpr auto all_of() {
-        using registry_type = RegistryT;
-        using condition_type = basic_function<registry_type, bool>;
+            return *this;
+        }
 
-        return [](registry_type& reg, uint64_t tick) {
-            return (condition_type{Funcs}(reg, tick) && ...);
-        };
-    }
+        // the time a task system may run in each run, `co_await budget_exhausted()` suspends it once spent
+        self_type& budget(duration_type budget) noexcept {
+            _budget = budget;
 
-    template<typename RegistryT, auto... Funcs>
-    constexpr auto any_of() {
-        using registry_type = RegistryT;
-        using condition_type = basic_function<registry_type, bool>;
+            return *this;
+        }
 
-        return [](registry_type& reg, uint64_t tick) {
-            return (condition_type{Funcs}(reg, tick) || ...);
-        };
-    }
+    public:
+        auto function() noexcept {
+            return _function;
+        }
 
-    template<typename RegistryT, auto Func>
-    constexpr auto not_of() {
-        using registry_type = RegistryT;
-        using condition_type = basic_function<registry_type, bool>;
+        auto runifs() && noexcept {
+            return std::move(_runifs);
+        }
 
-        return [](registry_type& reg, uint64_t tick) {
-            return !condition_type{Func}(reg, tick);
-        };
-    }
-}
+        auto befores() && noexcept {
+            return std::move(_befores);
+        }
 
-namespace mytho::ecs::internal {
-    template<typename RegistryT>
-    class basic_meta_system final {
-    public:
-        using registry_type = RegistryT;
-        using self_type = basic_meta_system<registry_type>;
-        using tick_type = uint64_t;
-        using function_type = basic_function<registry_type, void>;
-        using runif_type = basic_function<registry_type, bool>;
-        using runifs_type = std::vector<runif_type>;
+        auto afters() && noexcept {
+            return std::move(_afters);
+        }
 
-    public:
-        basic_meta_system() noexcept = default;
+        auto sets() && noexcept {
+            return std::move(_sets);
+        }
 
-        template<mytho::core::FunctionType Func>
-        basic_meta_system(Func&& func) noexcept
-            : _function(std::forward<Func>(func)), _runifs(), _last_run_tick(0) {}
+        bool is_exclusive() const noexcept {
+            return _exclusive;
+        }
 
-        basic_meta_system(function_type&& func, runifs_type&& runifs, tick_type tick = 0) noexcept
-            : _function(func), _runifs(std::move(runifs)), _last_run_tick(tick) {}
+        bool is_main_thread() const noexcept {
+            return _main_thread;
+        }
 
-    public:
-        void operator()(registry_type& reg, uint64_t tick) {
-            for (auto& runif : _runifs) {
-                if (runif.address() && !runif(reg, _last_run_tick)) {
-                    return;
-                }
-            }
+        std::string_view get_name() const noexcept {
+            return _name;
+        }
 
-            _function(reg, _last_run_tick);
-            _last_run_tick = tick;
+        duration_type get_budget() const noexcept {
+            return _budget;
         }
 
     private:
-        tick_type _last_run_tick = 0;
-        function_type _function{};
-        runifs_type _runifs{};
+        function_type _function;
+        runifs_type _runifs;
+        befores_type _befores;
+        afters_type _afters;
+        sets_type _sets;
+        bool _exclusive = false;
+        bool _main_thread = false;
+        std::string_view _name;
+        duration_type _budget = duration_type::zero();
     };
 
+    /*
+     * the ordering and run conditions shared by the systems in a set, see `basic_system::in_set`.
+     * the run conditions are evaluated once per schedule run before the systems of the set, not once per system.
+     */
     template<typename RegistryT>
-    class basic_system final {
+    class basic_system_set final {
     public:
         using registry_type = RegistryT;
-        using self_type = basic_system<registry_type>;
-        using function_type = basic_function<registry_type, void>;
+        using self_type = basic_system_set<registry_type>;
         using runif_type = basic_function<registry_type, bool>;
         using runifs_type = std::vector<runif_type>;
         using befores_type = std::vector<std::uintptr_t>;
         using afters_type = std::vector<std::uintptr_t>;
 
-        basic_system() noexcept = default;
-
-        template<mytho::core::FunctionType Func>
-        basic_system(Func&& func) noexcept : _function(std::forward<Func>(func)) {}
+        basic_system_set(std::uintptr_t key, std::string_view name) noexcept : _key(key), _name(name) {}
 
     public:
         template<mytho::core::FunctionType Func>
@@ -313,6 +1231,20 @@ namespace mytho::ecs::internal {
             return *this;
         }
 
+        template<auto SetE>
+        self_type& after() {
+            _afters.push_back(set_key<SetE>());
+
+            return *this;
+        }
+
+        template<typename SetT>
+        self_type& after() {
+            _afters.push_back(set_key<SetT>());
+
+            return *this;
+        }
+
         template<mytho::core::FunctionType Func>
         self_type& before(Func&& func) {
             using Fp = decltype(+std::declval<Func>());
@@ -323,6 +1255,20 @@ namespace mytho::ecs::internal {
             return *this;
         }
 
+        template<auto SetE>
+        self_type& before() {
+            _befores.push_back(set_key<SetE>());
+
+            return *this;
+        }
+
+        template<typename SetT>
+        self_type& before() {
+            _befores.push_back(set_key<SetT>());
+
+            return *this;
+        }
+
         template<mytho::core::FunctionType Func>
         self_type& runif(Func&& func) noexcept {
             _runifs.emplace_back(std::forward<Func>(func));
@@ -331,9 +1277,9 @@ namespace mytho::ecs::internal {
         }
 
     public:
-        auto function() noexcept {
-            return _function;
-        }
+        std::uintptr_t key() const noexcept { return _key; }
+
+        std::string_view name() const noexcept { return _name; }
 
         auto runifs() && noexcept {
             return std::move(_runifs);
@@ -348,7 +1294,8 @@ namespace mytho::ecs::internal {
         }
 
     private:
-        function_type _function;
+        std::uintptr_t _key;
+        std::string_view _name;
         runifs_type _runifs;
         befores_type _befores;
         afters_type _afters;
@@ -362,29 +1309,67 @@ namespace mytho::ecs::internal {
 
         using meta_system_type = basic_meta_system<registry_type>;
         using system_type = basic_system<registry_type>;
+        using system_set_type = basic_system_set<registry_type>;
         using befores_type = typename system_type::befores_type;
         using afters_type = typename system_type::afters_type;
+        using sets_type = typename system_type::sets_type;
 
-        using meta_systems_type = std::vector<meta_system_type>;
+        // a deque keeps the systems in place when more are added, so the sorted layers point to them
+        using meta_systems_type = std::deque<meta_system_type>;
         using befores_pool_type = std::vector<befores_type>;
         using afters_pool_type = std::vector<afters_type>;
+        using sets_pool_type = std::vector<sets_type>;
         using size_type = typename meta_systems_type::size_type;
         using id_map_type = std::unordered_map<std::uintptr_t, size_type>;
+        using edges_type = std::vector<std::vector<size_type>>;
+        using in_degrees_type = std::vector<size_type>;
+        using edge_set_type = std::unordered_set<uint64_t>;
+
+        using meta_system_ptrs_type = std::vector<meta_system_type*>;
+        using meta_systems_pool_type = std::vector<meta_system_ptrs_type>;
+        using report_type = basic_schedule_report;
+
+    private:
+        struct node_graph_type {
+            meta_system_ptrs_type nodes;
+            edges_type edges;
+            in_degrees_type in_degrees;
+        };
+
+        // a configured set, `system` evaluates its run conditions into `result`, null if it has none
+        struct set_config_type {
+            std::uintptr_t key;
+            befores_type befores;
+            afters_type afters;
+            meta_system_type* system;
+            bool result;
+        };
+
+    public:
+        using set_configs_type = std::deque<set_config_type>;
 
-        using meta_systems_pool_type = std::vector<meta_systems_type>;
+        inline static constexpr size_type node_null = std::numeric_limits<size_type>::max();
 
         basic_system_graph() noexcept = default;
         basic_system_graph(basic_system_graph& ss) noexcept = delete;
 
         basic_system_graph(basic_system_graph&& ss) noexcept
             : _meta_systems(std::move(ss).meta_systems()), _befores_pool(std::move(ss).befores_pool()),
-            _afters_pool(std::move(ss).afters_pool()), _id_map(std::move(ss).id_map()) {}
+            _afters_pool(std::move(ss).afters_pool()), _sets_pool(std::move(ss).sets_pool()), _id_map(std::move(ss).id_map()),
+            _set_systems(std::move(ss).set_systems()), _sets(std::move(ss).sets()), _set_map(std::move(ss).set_map()),
+            _pool(std::move(ss).pool()), _dirty(ss._dirty) {}
 
         basic_system_graph& operator=(basic_system_graph&& ss) noexcept {
             _meta_systems = std::move(ss).meta_systems();
             _befores_pool = std::move(ss).befores_pool();
             _afters_pool = std::move(ss).afters_pool();
+            _sets_pool = std::move(ss).sets_pool();
             _id_map = std::move(ss).id_map();
+            _set_systems = std::move(ss).set_systems();
+            _sets = std::move(ss).sets();
+            _set_map = std::move(ss).set_map();
+            _pool = std::move(ss).pool();
+            _dirty = ss._dirty;
 
             return *this;
         }
@@ -403,8 +1388,10 @@ namespace mytho::ecs::internal {
             _meta_systems.emplace_back(std::forward<Func>(func));
             _befores_pool.emplace_back();
             _afters_pool.emplace_back();
+            _sets_pool.emplace_back();
 
             _id_map[addr] = _meta_systems.size() - 1;
+            _dirty = true;
         }
 
         void add(system_type& system) {
@@ -412,48 +1399,180 @@ namespace mytho::ecs::internal {
                 return;
             }
 
-            _meta_systems.emplace_back(std::move(system).function(), std::move(system).runifs());
+            _meta_systems.emplace_back(std::move(system).function(), std::move(system).runifs(), system.is_exclusive(),
+                system.is_main_thread(), system.get_name(), system.get_budget());
             _befores_pool.push_back(std::move(system).befores());
             _afters_pool.push_back(std::move(system).afters());
+            _sets_pool.push_back(std::move(system).sets());
 
             _id_map[system.function().address()] = _meta_systems.size() - 1;
+            _dirty = true;
+        }
+
+        void configure(system_set_type& set) {
+            ASSURE(!_set_map.contains(set.key()), "system set already configured!");
+
+            auto& config = _sets.emplace_back(set_config_type{ set.key(), std::move(set).befores(), std::move(set).afters(), nullptr, true });
+
+            auto runifs = std::move(set).runifs();
+            if (!runifs.empty()) {
+                config.system = &_set_systems.emplace_back(std::move(runifs), &config.result, set.name());
+            }
+
+            _set_map[config.key] = _sets.size() - 1;
+            _dirty = true;
         }
 
     public:
-        auto sort() {
-            meta_systems_pool_type pool;
+        // the systems in sorted layers, the layers are cached and sorted again only after systems are added
+        const meta_systems_pool_type& sort() {
+            if (_dirty) {
+                _pool = build();
+                _dirty = false;
+            }
 
-            auto size = _meta_systems.size();
-            if (size < 1) return pool;
+            return _pool;
+        }
 
-            if (size == 1) {
-                pool.push_back(std::move(_meta_systems));
-            } else {
-                mytho::storage::basic_sparse_set<size_type, 64> ids;
-                for (auto i = 0; i < size; i++) {
-                    ids.add(i);
+        // systems are added since the last sort
+        bool dirty() const noexcept { return _dirty; }
+
+        /*
+         * the layers, the ordering edges and the ambiguities of the systems, see `basic_schedule_report`.
+         * O(V * (V + E) / 64), the systems reachable from each node are kept in bitsets, it is meant for tests and tools.
+         */
+        report_type report(std::string_view schedule) {
+            using access_type = typename meta_system_type::access_type;
+
+            auto graph = connect_nodes();
+            auto in_degrees = graph.in_degrees;
+            auto layers = kahn(graph.nodes, graph.edges, in_degrees);
+
+            report_type report;
+            report.schedule = schedule;
+
+            // the systems are numbered in layer order
+            std::unordered_map<const meta_system_type*, size_type> ids;
+            meta_system_ptrs_type systems;
+
+            for (size_type l = 0; l < layers.size(); ++l) {
+                report.layer_widths.push_back(layers[l].size());
+
+                for (auto system : layers[l]) {
+                    ids[system] = systems.size();
+                    systems.push_back(system);
+                    report.systems.push_back({ system->name(), system->address(), l, system->access().exclusive() });
+                }
+            }
+
+            auto size = graph.nodes.size();
+            auto count = systems.size();
+            auto words = (count + 63) / 64;
+
+            std::vector<size_type> index(size, node_null);
+            std::vector<size_type> system_nodes(count);
+            for (size_type i = 0; i < size; ++i) {
+                if (graph.nodes[i]) {
+                    index[i] = ids[graph.nodes[i]];
+                    system_nodes[index[i]] = i;
+                }
+            }
+
+            // the systems reachable from each node, filled in reverse topological order
+            std::vector<uint64_t> reach(size * words, 0);
+            auto order = topological_order(graph);
+
+            for (auto it = order.rbegin(); it != order.rend(); ++it) {
+                auto node = *it;
+
+                for (auto next : graph.edges[node]) {
+                    for (size_type w = 0; w < words; ++w) {
+                        reach[node * words + w] |= reach[next * words + w];
+                    }
+
+                    if (index[next] != node_null) {
+                        reach[node * words + index[next] / 64] |= uint64_t(1) << (index[next] % 64);
+                    }
+                }
+            }
+
+            auto reachable = [&reach, &system_nodes, words](size_type from, size_type to) {
+                return (reach[system_nodes[from] * words + to / 64] >> (to % 64)) & 1;
+            };
+
+            // the edges between systems, the nodes without a system in between are skipped
+            std::vector<size_type> stack;
+            std::vector<size_type> seen(size, node_null);
+            edge_set_type edge_set;
+
+            for (size_type i = 0; i < count; ++i) {
+                stack.assign(graph.edges[system_nodes[i]].begin(), graph.edges[system_nodes[i]].end());
+
+                while (!stack.empty()) {
+                    auto node = stack.back();
+                    stack.pop_back();
+
+                    if (index[node] == node_null) {
+                        if (seen[node] == i) {
+                            continue;
+                        }
+
+                        seen[node] = i;
+                        stack.insert(stack.end(), graph.edges[node].begin(), graph.edges[node].end());
+                    } else if (edge_set.insert((static_cast<uint64_t>(i) << 32) | index[node]).second) {
+                        report.edges.push_back({ i, index[node] });
+                    }
                 }
+            }
+
+            for (size_type i = 0; i < count; ++i) {
+                for (size_type j = i + 1; j < count; ++j) {
+                    auto& first = systems[i]->access();
+                    auto& second = systems[j]->access();
 
-                auto graph = build(ids);
-                size = graph.size();
-                pool.resize(size);
+                    if (!first.conflict(second) || reachable(i, j) || reachable(j, i)) {
+                        continue;
+                    }
 
-                for (auto i = 0; i < size; ++i) {
-                    auto& vec = graph[i];
-                    auto in_size = vec.size();
+                    typename access_type::component_ids_type components;
+                    typename access_type::resource_ids_type resources;
+                    first.conflicts(second, components, resources);
 
-                    auto& systems = pool[i];
-                    systems.reserve(in_size);
+                    auto& ambiguity = report.ambiguities.emplace_back();
+                    ambiguity.first = i;
+                    ambiguity.second = j;
+                    ambiguity.exclusive = first.exclusive() || second.exclusive();
 
-                    for (auto j = 0; j < in_size; ++j) {
-                        auto id = vec[j];
+                    for (auto id : components) {
+                        ambiguity.components.push_back(access_type::component_name(id));
+                    }
 
-                        systems.push_back(_meta_systems[id]);
+                    for (auto id : resources) {
+                        ambiguity.resources.push_back(access_type::resource_name(id));
                     }
                 }
             }
 
-            return pool;
+            return report;
+        }
+
+        // the system of the function address, null if it is not added
+        meta_system_type* find(std::uintptr_t address) noexcept {
+            auto it = _id_map.find(address);
+
+            return it == _id_map.end() ? nullptr : &_meta_systems[it->second];
+        }
+
+        // call `func(system)` for each system in the order they are added, then for the systems of the sets
+        template<typename FuncT>
+        void each(FuncT&& func) {
+            for (auto& system : _meta_systems) {
+                func(system);
+            }
+
+            for (auto& system : _set_systems) {
+                func(system);
+            }
         }
 
     public:
@@ -463,114 +1582,240 @@ namespace mytho::ecs::internal {
 
         auto afters_pool() && noexcept { return std::move(_afters_pool); }
 
+        auto sets_pool() && noexcept { return std::move(_sets_pool); }
+
         auto id_map() && noexcept { return std::move(_id_map); }
 
+        auto set_systems() && noexcept { return std::move(_set_systems); }
+
+        auto sets() && noexcept { return std::move(_sets); }
+
+        auto set_map() && noexcept { return std::move(_set_map); }
+
+        auto pool() && noexcept { return std::move(_pool); }
+
         auto size() const noexcept { return _meta_systems.size(); }
 
         void clear() noexcept {
             _meta_systems.clear();
             _befores_pool.clear();
             _afters_pool.clear();
+            _sets_pool.clear();
             _id_map.clear();
+            _set_systems.clear();
+            _sets.clear();
+            _set_map.clear();
+            _pool.clear();
+            _dirty = false;
         }
 
     private:
         meta_systems_type _meta_systems;
         befores_pool_type _befores_pool;
         afters_pool_type _afters_pool;
+        sets_pool_type _sets_pool;
         id_map_type _id_map;
+        meta_systems_type _set_systems;
+        set_configs_type _sets;
+        id_map_type _set_map;
+        meta_systems_pool_type _pool;
+        bool _dirty = false;
 
     private:
-        auto build(auto& ids) {
-            std::vector<std::vector<size_type>> edges(ids.size());
-            std::vector<size_t> in_degrees(ids.size(), 0);
+        /*
+         * O(V + E), the duplicated edges are dropped by a hash set instead of searching the edge lists.
+         * each set has a begin and an end node, the systems in the set run between them, so the ordering of a set
+         * takes one edge per member instead of one per pair of systems.
+         * the begin node of a set with run conditions is the system evaluating them, the other set nodes only order.
+         */
+        meta_systems_pool_type build() {
+            bind_sets();
+
+            auto graph = connect_nodes();
+            return kahn(graph.nodes, graph.edges, graph.in_degrees);
+        }
 
-            auto size = ids.size();
-            for (auto i = 0; i < size; i++) {
-                auto id = ids[i];
-                auto& befores = _befores_pool[id];
-                auto bf_size = befores.size();
+        // the systems check the results of the sets they are in, which the systems of the sets evaluate
+        void bind_sets() {
+            auto size = _meta_systems.size();
 
-                for (auto j = 0; j < bf_size; ++j) {
-                    auto p = befores[j];
+            for (size_type i = 0; i < size; ++i) {
+                typename meta_system_type::set_results_type results;
 
-                    if (!_id_map.contains(p)) {
-                        continue;
+                for (auto key : _sets_pool[i]) {
+                    if (auto it = _set_map.find(key); it != _set_map.end() && _sets[it->second].system) {
+                        results.push_back(&_sets[it->second].result);
                     }
+                }
 
-                    auto pid = _id_map[p];
-                    if (!ids.contain(pid)) {
-                        continue;
-                    }
+                _meta_systems[i].bind_sets(std::move(results));
+            }
+        }
+
+        // the nodes are the systems, then the begin and end node of each set, a null node has no system
+        node_graph_type connect_nodes() {
+            auto size = _meta_systems.size();
 
-                    auto v = ids.index(pid);
-                    auto& edge = edges[i];
-                    if (std::find(edge.begin(), edge.end(), v) == edge.end()) {
-                        edge.push_back(v);
-                        in_degrees[v]++;
+            meta_system_ptrs_type nodes;
+            nodes.reserve(size + _sets.size() * 2);
+            for (auto& system : _meta_systems) {
+                nodes.push_back(&system);
+            }
+
+            // the begin node of each set, the end node follows it, the sets only joined by systems are not configured
+            id_map_type set_nodes;
+            for (auto& set : _sets) {
+                set_nodes[set.key] = nodes.size();
+                nodes.push_back(set.system);
+                nodes.push_back(nullptr);
+            }
+
+            for (auto& sets : _sets_pool) {
+                for (auto key : sets) {
+                    if (set_nodes.emplace(key, nodes.size()).second) {
+                        nodes.push_back(nullptr);
+                        nodes.push_back(nullptr);
                     }
                 }
+            }
 
-                auto& afters = _afters_pool[id];
-                auto af_size = afters.size();
+            edges_type edges(nodes.size());
+            in_degrees_type in_degrees(nodes.size(), 0);
+            edge_set_type edge_set;
 
-                for (auto j = 0; j < af_size; ++j) {
-                    auto p = afters[j];
+            auto connect = [&edges, &in_degrees, &edge_set](size_type from, size_type to) {
+                if (edge_set.insert((static_cast<uint64_t>(from) << 32) | to).second) {
+                    edges[from].push_back(to);
+                    ++in_degrees[to];
+                }
+            };
 
-                    if (!_id_map.contains(p)) {
-                        continue;
+            // a system, or the begin (end if `end` is set) node of a set, node_null if neither is added
+            auto node = [this, &set_nodes](std::uintptr_t key, bool end) {
+                if (auto it = _id_map.find(key); it != _id_map.end()) {
+                    return it->second;
+                }
+
+                if (auto it = set_nodes.find(key); it != set_nodes.end()) {
+                    return it->second + end;
+                }
+
+                return node_null;
+            };
+
+            auto connect_befores = [&connect, &node](size_type from, const befores_type& befores) {
+                for (auto p : befores) {
+                    if (auto to = node(p, false); to != node_null) {
+                        connect(from, to);
                     }
+                }
+            };
 
-                    auto pid = _id_map[p];
-                    if (!ids.contain(pid)) {
-                        continue;
+            auto connect_afters = [&connect, &node](size_type to, const afters_type& afters) {
+                for (auto p : afters) {
+                    if (auto from = node(p, true); from != node_null) {
+                        connect(from, to);
                     }
+                }
+            };
+
+            for (size_type i = 0; i < size; ++i) {
+                connect_befores(i, _befores_pool[i]);
+                connect_afters(i, _afters_pool[i]);
+
+                for (auto key : _sets_pool[i]) {
+                    auto begin = set_nodes[key];
+                    connect(begin, i);
+                    connect(i, begin + 1);
+                }
+            }
+
+            for (auto& set : _sets) {
+                auto begin = set_nodes[set.key];
+                connect(begin, begin + 1);
+                connect_befores(begin + 1, set.befores);
+                connect_afters(begin, set.afters);
+            }
+
+            return node_graph_type{ std::move(nodes), std::move(edges), std::move(in_degrees) };
+        }
+
+        std::vector<size_type> topological_order(const node_graph_type& graph) {
+            auto in_degrees = graph.in_degrees;
+            std::vector<size_type> order;
+
+            for (size_type i = 0; i < in_degrees.size(); ++i) {
+                if (in_degrees[i] == 0) {
+                    order.push_back(i);
+                }
+            }
 
-                    auto k = ids.index(pid);
-                    auto& edge = edges[k];
-                    if (std::find(edge.begin(), edge.end(), i) == edge.end()) {
-                        edge.push_back(i);
-                        in_degrees[i]++;
+            for (size_type i = 0; i < order.size(); ++i) {
+                for (auto next : graph.edges[order[i]]) {
+                    if (--in_degrees[next] == 0) {
+                        order.push_back(next);
                     }
                 }
             }
 
-            return kahn(edges, in_degrees, ids);
+            return order;
         }
 
-        auto kahn(auto& edges, auto& in_degrees, auto& ids) {
+        // the nodes without a system take no layer, the systems after them go into the layer they would go without them
+        meta_systems_pool_type kahn(const meta_system_ptrs_type& nodes, const edges_type& edges, in_degrees_type& in_degrees) {
             std::vector<size_type> v;
+            std::vector<size_type> passes;
+            size_t count = 0;
 
             auto size = in_degrees.size();
-            for (auto i = 0; i < size; ++i) {
+            for (size_type i = 0; i < size; ++i) {
                 if (in_degrees[i] == 0) {
-                    v.push_back(i);
+                    (nodes[i] ? v : passes).push_back(i);
                 }
             }
 
-            std::vector<std::vector<size_type>> result;
-            size_t count = 0;
+            // the nodes without a system are passed through at once, the systems freed by them join `next`
+            auto pass = [&nodes, &edges, &in_degrees, &passes, &count](std::vector<size_type>& next) {
+                while (!passes.empty()) {
+                    auto id = passes.back();
+                    passes.pop_back();
+                    ++count;
+
+                    for (auto idx : edges[id]) {
+                        if (--in_degrees[idx] == 0) {
+                            (nodes[idx] ? next : passes).push_back(idx);
+                        }
+                    }
+                }
+            };
+
+            pass(v);
+
+            meta_systems_pool_type result;
 
             while(!v.empty()) {
                 count += v.size();
-                auto& back = result.emplace_back(); // emplace_back will return ref after c++17
-
-                back.swap(v);
-                auto new_size = back.size();
-                for (auto i = 0; i < new_size; ++i) {
-                    auto& it = back[i];
-                    auto id = it;
-                    it = ids[id];
-
-                    auto& edge = edges[id];
-                    auto in_size = edge.size();
-                    for (auto j = 0; j < in_size; ++j) {
-                        auto idx = edge[j];
+
+                std::vector<size_type> layer;
+                layer.swap(v);
+
+                auto& systems = result.emplace_back(); // emplace_back will return ref after c++17
+                systems.reserve(layer.size());
+
+                for (auto id : layer) {
+                    systems.push_back(nodes[id]);
+
+                    for (auto idx : edges[id]) {
                         if (--in_degrees[idx] == 0) {
-                            v.push_back(idx);
+                            (nodes[idx] ? v : passes).push_back(idx);
                         }
                     }
                 }
+
+                // the exclusive systems go last, so the others of the layer run together before them
+                std::stable_partition(systems.begin(), systems.end(), [](auto system) { return !system->access().exclusive(); });
+
+                pass(v);
             }
 
             ASSURE(count == in_degrees.size(), "Cycle detected in system dependencies.");
@@ -0,0 +1,77 @@
+#pragma once
+#include <type_traits>
+
+namespace mytho::storage {
+    /*
+     * lifecycle hooks of component, detected at compile time, so components without hooks pay nothing.
+     *
+     * there are two ways to attach hooks to a component type `T`:
+     *      1. declare static member functions in `T`;
+     *      2. specialize `component_hooks<T>` with static member functions, for types we can not touch.
+     *
+     * supported hooks (all optional):
+     *      static void on_add(const Entity& e, T& component);      // component added to the entity
+     *      static void on_insert(const Entity& e, T& component);   // component value written, by add or replace
+     *      static void on_replace(const Entity& e, T& component);  // old component value, before replace overwrites it
+     *      static void on_remove(const Entity& e, T& component);   // component value, before it is removed or despawned
+     *
+     * hooks run inline within the storage mutation, so they must not add or remove components of the same type.
+     */
+    template<typename ComponentT>
+    struct component_hooks {};
+
+    namespace internal {
+        template<typename EntityT, typename ComponentT>
+        struct component_hooks_invoker final {
+            using entity_type = EntityT;
+            using component_type = ComponentT;
+            using hooks_type = component_hooks<component_type>;
+
+            static constexpr bool has_on_add = requires(const entity_type& e, component_type& c) { hooks_type::on_add(e, c); }
+                || requires(const entity_type& e, component_type& c) { component_type::on_add(e, c); };
+
+            static constexpr bool has_on_insert = requires(const entity_type& e, component_type& c) { hooks_type::on_insert(e, c); }
+                || requires(const entity_type& e, component_type& c) { component_type::on_insert(e, c); };
+
+            static constexpr bool has_on_replace = requires(const entity_type& e, component_type& c) { hooks_type::on_replace(e, c); }
+                || requires(const entity_type& e, component_type& c) { component_type::on_replace(e, c); };
+
+            static constexpr bool has_on_remove = requires(const entity_type& e, component_type& c) { hooks_type::on_remove(e, c); }
+                || requires(const entity_type& e, component_type& c) { component_type::on_remove(e, c); };
+
+            static constexpr bool has_any = has_on_add || has_on_insert || has_on_replace || has_on_remove;
+
+            static void on_add(const entity_type& e, component_type& c) {
+                if constexpr (requires { hooks_type::on_add(e, c); }) {
+                    hooks_type::on_add(e, c);
+                } else if constexpr (requires { component_type::on_add(e, c); }) {
+                    component_type::on_add(e, c);
+                }
+            }
+
+            static void on_insert(const entity_type& e, component_type& c) {
+                if constexpr (requires { hooks_type::on_insert(e, c); }) {
+                    hooks_type::on_insert(e, c);
+                } else if constexpr (requires { component_type::on_insert(e, c); }) {
+                    component_type::on_insert(e, c);
+                }
+            }
+
+            static void on_replace(const entity_type& e, component_type& c) {
+                if constexpr (requires { hooks_type::on_replace(e, c); }) {
+                    hooks_type::on_replace(e, c);
+                } else if constexpr (requires { component_type::on_replace(e, c); }) {
+                    component_type::on_replace(e, c);
+                }
+            }
+
+            static void on_remove(const entity_type& e, component_type& c) {
+                if constexpr (requires { hooks_type::on_remove(e, c); }) {
+                    hooks_type::on_remove(e, c);
+                } else if constexpr (requires { component_type::on_remove(e, c); }) {
+                    component_type::on_remove(e, c);
+                }
+            }
+        };
+    }
+}
\ No newline at end of file
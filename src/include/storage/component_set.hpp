@@ -26,6 +26,8 @@ namespace mytho::storage {
 
         using component_data_ptr_set_type = std::vector<component_data_ptr_type, typename alloc_traits::template rebind_alloc<component_data_ptr_type>>;
         using component_tick_set_type = basic_tick_set;
+        using observer_type = base_type;
+        using observers_type = std::vector<observer_type*>;
 
         using size_type = typename base_type::size_type;
 
@@ -63,6 +65,12 @@ namespace mytho::storage {
             // component added, is_added case is considered in is_changed case
             _ticks.set_added_tick(idx, tick);
             _ticks.set_changed_tick(idx, tick);
+
+            _last_added_tick = tick;
+            _last_changed_tick = tick;
+
+            observe(_added_observers, e);
+            observe(_changed_observers, e);
         }
 
         // must ensure entity exist
@@ -70,6 +78,9 @@ namespace mytho::storage {
             auto idx = base_type::index(e);
             auto last = base_type::size() - 1;
 
+            unobserve(_added_observers, e);
+            unobserve(_changed_observers, e);
+
             base_type::remove(e);
 
             // allocator_type allocator{_cdata.get_allocator()};
@@ -82,6 +93,26 @@ namespace mytho::storage {
             }
         }
 
+        // remove the components of all entities, the memory of components and sparse pages is kept for reusing
+        void remove_all() noexcept {
+            auto size = base_type::size();
+
+            if (!_added_observers.empty() || !_changed_observers.empty()) {
+                for (size_type i = 0; i < size; ++i) {
+                    auto e = base_type::operator[](i);
+
+                    unobserve(_added_observers, e);
+                    unobserve(_changed_observers, e);
+                }
+            }
+
+            for (size_type i = 0; i < size; ++i) {
+                _cdata[i]->~component_type();
+            }
+
+            base_type::reset();
+        }
+
         // must ensure entity exist
         template<typename... Ts>
         requires (sizeof...(Ts) > 0)
@@ -91,6 +122,9 @@ namespace mytho::storage {
             new (_cdata[idx]) component_type{ std::forward<Ts>(ts)... };
 
             _ticks.set_changed_tick(idx, tick);
+            _last_changed_tick = tick;
+
+            observe(_changed_observers, e);
         }
 
         // must ensure entity exist
@@ -132,6 +166,60 @@ namespace mytho::storage {
             return base_type::contain(e);
         }
 
+        // the observers collect the entities whose component is added/changed, they must outlive this set
+        void add_added_observer(observer_type& observer) {
+            _added_observers.push_back(&observer);
+        }
+
+        void add_changed_observer(observer_type& observer) {
+            _changed_observers.push_back(&observer);
+        }
+
+        bool changed_observed() const noexcept {
+            return !_changed_observers.empty();
+        }
+
+        // used by `data_wrapper`, the changed tick reference locates the entity whose component is mutably accessed
+        static void notify_changed(void* ptr, const uint64_t& changed_tick) {
+            auto& cs = *static_cast<basic_component_set*>(ptr);
+            auto idx = &changed_tick - &cs._ticks.get_changed_tick(0);
+
+            cs.observe(cs._changed_observers, cs[idx]);
+        }
+
+        /*
+         * the watermarks are the latest ticks of all added/changed operations in this set,
+         * they are upper bounds of the entity ticks, because removals do not lower them.
+         */
+        uint64_t last_added_tick() const noexcept {
+            return _last_added_tick;
+        }
+
+        uint64_t last_changed_tick() const noexcept {
+            return _last_changed_tick;
+        }
+
+        uint64_t& last_changed_tick() noexcept {
+            return _last_changed_tick;
+        }
+
+        // allocate the memory of components up front, so adding the first `size` components does not allocate
+        void reserve(size_type size) {
+            base_type::reserve(size);
+
+            auto data_size = _cdata.size();
+            if (size > data_size) {
+                allocator_type allocator{_cdata.get_allocator()};
+
+                _cdata.resize(size);
+                _ticks.resize(size);
+
+                for (auto i = data_size; i < size; i++) {
+                    _cdata[i] = alloc_traits::allocate(allocator, 1);
+                }
+            }
+        }
+
         void clear() noexcept {
             auto size = base_type::size();
             allocator_type allocator{_cdata.get_allocator()};
@@ -150,6 +238,9 @@ namespace mytho::storage {
             _cdata.clear();
             _ticks.clear();
             base_type::clear();
+
+            _last_added_tick = 0;
+            _last_changed_tick = 0;
         }
 
     public:
@@ -160,5 +251,26 @@ namespace mytho::storage {
     private:
         component_data_ptr_set_type _cdata;
         component_tick_set_type _ticks;
+        uint64_t _last_added_tick = 0;
+        uint64_t _last_changed_tick = 0;
+        observers_type _added_observers;
+        observers_type _changed_observers;
+
+    private:
+        static void observe(observers_type& observers, const entity_type& e) {
+            for (auto* observer : observers) {
+                if (!observer->contain(e)) {
+                    observer->add(e);
+                }
+            }
+        }
+
+        static void unobserve(observers_type& observers, const entity_type& e) noexcept {
+            for (auto* observer : observers) {
+                if (observer->contain(e)) {
+                    observer->remove(e);
+                }
+            }
+        }
     };
 }
\ No newline at end of file
@@ -3,9 +3,12 @@
 #include <tuple>
 #include <memory>
 #include <utility>
+#include <algorithm>
 #include <cstdint>
 
 #include "storage/component_set.hpp"
+#include "storage/component_hooks.hpp"
+#include "storage/removed_log.hpp"
 
 namespace mytho::storage {
     template<
@@ -22,12 +25,21 @@ namespace mytho::storage {
         template<typename ComponentT>
         using allocator_template_type = AllocatorTemplateT<ComponentT>;
 
+        template<typename ComponentT>
+        using hooks_invoker_type = internal::component_hooks_invoker<entity_type, ComponentT>;
+
         using component_id_type = typename component_id_generator::value_type;
         using component_set_base_type = basic_entity_set<entity_type, PageSize>;
 
         using component_pool_type = std::vector<std::unique_ptr<component_set_base_type>>;
         using entity_remove_functions_type = std::vector<void(*)(void*, const entity_type&)>;
-        using removed_entities_type = std::vector<std::vector<entity_type>>;
+        using entity_remove_all_functions_type = std::vector<void(*)(void*)>;
+        using entities_type = std::vector<entity_type>;
+        using entity_groups_type = std::vector<entities_type>;
+        using removed_log_type = basic_removed_log<entity_type>;
+        using removed_entities_type = std::vector<removed_log_type>;
+        using observer_type = component_set_base_type;
+        using observer_pool_type = std::vector<std::unique_ptr<observer_type>>;
 
         using size_type = typename component_pool_type::size_type;
 
@@ -45,16 +57,56 @@ namespace mytho::storage {
         template<mytho::core::PureValueType... Ts>
         requires (sizeof...(Ts) > 0)
         void add(const entity_type& e, uint64_t tick, Ts&&... ts) {
-            (assure<Ts>().add(e, tick, std::forward<Ts>(ts)), ...);
+            (_add(e, tick, std::forward<Ts>(ts)), ...);
+        }
+
+        // reserve the memory for `count` more components of each type
+        template<mytho::core::PureValueType... Ts>
+        requires (sizeof...(Ts) > 0)
+        void reserve(size_type count) {
+            ([this, count](auto& cs) { cs.reserve(cs.size() + count); }(assure<Ts>()), ...);
         }
 
         template<mytho::core::PureValueType... Ts>
-        void remove(const entity_type& e) {
+        void remove(const entity_type& e, uint64_t tick) {
             if constexpr (sizeof...(Ts) > 0) {
                 // must ensure the entity has all specific components
-                (_remove_components<Ts>(e), ...);
+                (_remove_components<Ts>(e, tick), ...);
             } else {
-                _remove_entity(e);
+                _remove_entity(e, tick);
+            }
+        }
+
+        // remove the components from all entities, each set is emptied at once and its removals are recorded at once
+        template<mytho::core::PureValueType... Ts>
+        requires (sizeof...(Ts) > 0)
+        void remove_all(uint64_t tick) {
+            (_remove_all(component_id_generator::template gen<Ts>(), tick), ...);
+        }
+
+        /*
+         * remove all components of many entities, `groups[id]` holds the entities which have the component of id,
+         * a set whose entities are all in the group is emptied at once instead of entity by entity.
+         */
+        void remove_entities(const entity_groups_type& groups, uint64_t tick) {
+            auto size = std::min(groups.size(), _pool.size());
+            for (size_type id = 0; id < size; ++id) {
+                auto& group = groups[id];
+                auto& p = _pool[id];
+
+                if (group.empty() || !p) {
+                    continue;
+                }
+
+                if (group.size() == p->size()) {
+                    _remove_all(id, tick);
+                } else {
+                    for (auto& e : group) {
+                        _remove_funcs[id](p.get(), e);
+                    }
+
+                    _removed_log(id).append(group, tick);
+                }
             }
         }
 
@@ -88,15 +140,34 @@ namespace mytho::storage {
             return (_is_changed<Ts>(e, tick) && ...);
         }
 
+        // check the watermarks, false means no entity matches, true means some entity may match
+        template<mytho::core::PureValueType... Ts>
+        requires (sizeof...(Ts) > 0)
+        bool is_any_added(uint64_t tick) const noexcept {
+            return (_is_any_added<Ts>(tick) && ...);
+        }
+
+        // check the watermarks, false means no entity matches, true means some entity may match
+        template<mytho::core::PureValueType... Ts>
+        requires (sizeof...(Ts) > 0)
+        bool is_any_changed(uint64_t tick) const noexcept {
+            return (_is_any_changed<Ts>(tick) && ...);
+        }
+
+        // the log is not created here, so the systems reading removed entities never resize the logs while running
         template<mytho::core::PureValueType T>
-        auto& removed_entities() {
+        const removed_log_type& removed_entities() const noexcept {
+            static const removed_log_type empty_log;
+
             auto id = component_id_generator::template gen<T>();
 
-            if (id >= _entities.size()) {
-                _entities.resize(id + 1, std::vector<entity_type>());
-            }
+            return id < _entities.size() ? _entities[id] : empty_log;
+        }
 
-            return _entities[id];
+        template<mytho::core::PureValueType... Ts>
+        requires (sizeof...(Ts) > 0)
+        bool is_removed(uint64_t tick) const noexcept {
+            return (_is_removed<Ts>(tick) && ...);
         }
 
         template<mytho::core::PureValueType... Ts>
@@ -114,14 +185,16 @@ namespace mytho::storage {
         void clear() {
             _pool.clear();
             _remove_funcs.clear();
+            _remove_all_funcs.clear();
             _entities.clear();
+            _observers.clear();
         }
 
-        void removed_entities_clear() noexcept {
-            // we do not need to clear whole container, just clear the sub vector to avoid repetitive memory allocation
+        void removed_entities_update() noexcept {
+            // the logs keep their ring buffers, so no memory is reallocated frame by frame
             auto size = _entities.size();
-            for (auto i= 0; i < _entities.size(); ++i) {
-                _entities[i].clear();
+            for (size_type i = 0; i < size; ++i) {
+                _entities[i].update();
             }
         }
 
@@ -132,27 +205,80 @@ namespace mytho::storage {
 
         component_set_base_type* operator[](size_type index) noexcept { return _pool[index].get(); }
 
+    public:
+        // create an empty observer, it is owned by the storage, so it outlives all component sets
+        size_type add_observer() {
+            _observers.push_back(std::make_unique<observer_type>());
+
+            return _observers.size() - 1;
+        }
+
+        // record the entities whose component T is added from now on, the entities already have T are recorded too
+        template<mytho::core::PureValueType T>
+        void observe_added(size_type observer_id) {
+            auto& cs = assure<T>();
+            auto& observer = *_observers[observer_id];
+
+            cs.add_added_observer(observer);
+            _observe_existing(cs, observer);
+        }
+
+        // record the entities whose component T is added or changed from now on, the entities already have T are recorded too
+        template<mytho::core::PureValueType T>
+        void observe_changed(size_type observer_id) {
+            auto& cs = assure<T>();
+            auto& observer = *_observers[observer_id];
+
+            cs.add_changed_observer(observer);
+            _observe_existing(cs, observer);
+        }
+
+        // must ensure observer exists
+        observer_type& observer(size_type observer_id) noexcept {
+            return *_observers[observer_id];
+        }
+
     private:
         component_pool_type _pool;
         entity_remove_functions_type _remove_funcs;
+        entity_remove_all_functions_type _remove_all_funcs;
         removed_entities_type _entities;
+        observer_pool_type _observers;
 
     private:
         template<typename T>
-        void _remove_components(const entity_type& e) {
+        void _add(const entity_type& e, uint64_t tick, T&& t) {
+            using hooks_invoker = hooks_invoker_type<T>;
+
+            auto& cs = assure<T>();
+            cs.add(e, tick, std::forward<T>(t));
+
+            if constexpr (hooks_invoker::has_on_add || hooks_invoker::has_on_insert) {
+                auto& c = cs.get(e);
+                hooks_invoker::on_add(e, c);
+                hooks_invoker::on_insert(e, c);
+            }
+        }
+
+        template<typename T>
+        void _remove_components(const entity_type& e, uint64_t tick) {
             using component_set_type = basic_component_set<entity_type, T, allocator_template_type<T>, PageSize>;
+            using hooks_invoker = hooks_invoker_type<T>;
 
             auto id = component_id_generator::template gen<T>();
-            static_cast<component_set_type&>(*_pool[id]).remove(e);
+            auto& cs = static_cast<component_set_type&>(*_pool[id]);
 
-            // record the removed entity
-            if (id >= _entities.size()) {
-                _entities.resize(id + 1, std::vector<entity_type>());
+            if constexpr (hooks_invoker::has_on_remove) {
+                hooks_invoker::on_remove(e, cs.get(e));
             }
-            _entities[id].push_back(e);
+
+            cs.remove(e);
+
+            // record the removed entity
+            _removed_log(id).push(e, tick);
         }
 
-        void _remove_entity(const entity_type& e) {
+        void _remove_entity(const entity_type& e, uint64_t tick) {
             auto size = _pool.size();
             for (size_type i = 0; i < size; ++i) {
                 auto& p = _pool[i];
@@ -160,20 +286,64 @@ namespace mytho::storage {
                     _remove_funcs[i](p.get(), e);
 
                     // record the removed entity
-                    if (i >= _entities.size()) {
-                        _entities.resize(i + 1, std::vector<entity_type>());
-                    }
-                    _entities[i].push_back(e);
+                    _removed_log(i).push(e, tick);
                 }
             }
         }
 
+        void _remove_all(size_type id, uint64_t tick) {
+            if (id >= _pool.size() || !_pool[id] || _pool[id]->empty()) {
+                return;
+            }
+
+            // record the removed entities before the set is emptied
+            _removed_log(id).append(*_pool[id], tick);
+            _remove_all_funcs[id](_pool[id].get());
+        }
+
+        template<typename ComponentSetT>
+        void _observe_existing(const ComponentSetT& cs, observer_type& observer) {
+            auto size = cs.size();
+            for (size_type i = 0; i < size; ++i) {
+                auto e = cs[i];
+                if (!observer.contain(e)) {
+                    observer.add(e);
+                }
+            }
+        }
+
+        removed_log_type& _removed_log(size_type id) {
+            if (id >= _entities.size()) {
+                _entities.resize(id + 1);
+            }
+
+            return _entities[id];
+        }
+
+        template<typename T>
+        bool _is_removed(uint64_t tick) const noexcept {
+            auto id = component_id_generator::template gen<T>();
+
+            return id < _entities.size() && _entities[id].removed(tick);
+        }
+
         template<typename T>
         void _replace(const entity_type& e, uint64_t tick, T&& t) {
             using component_set_type = basic_component_set<entity_type, T, allocator_template_type<T>, PageSize>;
+            using hooks_invoker = hooks_invoker_type<T>;
 
             auto id = component_id_generator::template gen<T>();
-            static_cast<component_set_type&>(*_pool[id]).replace(e, tick, t);
+            auto& cs = static_cast<component_set_type&>(*_pool[id]);
+
+            if constexpr (hooks_invoker::has_on_replace) {
+                hooks_invoker::on_replace(e, cs.get(e));
+            }
+
+            cs.replace(e, tick, std::forward<T>(t));
+
+            if constexpr (hooks_invoker::has_on_insert) {
+                hooks_invoker::on_insert(e, cs.get(e));
+            }
         }
 
         template<typename T>
@@ -206,6 +376,36 @@ namespace mytho::storage {
             return p.contain(e) && p.is_changed(e, tick);
         }
 
+        template<typename T>
+        bool _is_any_added(uint64_t tick) const noexcept {
+            using component_set_type = basic_component_set<entity_type, T, allocator_template_type<T>, PageSize>;
+
+            auto id = component_id_generator::template gen<T>();
+
+            if (id >= _pool.size() || !_pool[id]) {
+                return false;
+            }
+
+            auto& p = static_cast<const component_set_type&>(*_pool[id]);
+
+            return !p.empty() && p.last_added_tick() >= tick;
+        }
+
+        template<typename T>
+        bool _is_any_changed(uint64_t tick) const noexcept {
+            using component_set_type = basic_component_set<entity_type, T, allocator_template_type<T>, PageSize>;
+
+            auto id = component_id_generator::template gen<T>();
+
+            if (id >= _pool.size() || !_pool[id]) {
+                return false;
+            }
+
+            auto& p = static_cast<const component_set_type&>(*_pool[id]);
+
+            return !p.empty() && p.last_changed_tick() >= tick;
+        }
+
         template<typename T>
         bool _contain(const entity_type& e) const noexcept {
             auto id = component_id_generator::template gen<T>();
@@ -228,12 +428,36 @@ namespace mytho::storage {
             if (id >= _pool.size()) {
                 _pool.resize(id + 1);
                 _remove_funcs.resize(id + 1, nullptr);
+                _remove_all_funcs.resize(id + 1, nullptr);
             }
 
             if (!_pool[id]) {
                 _pool[id] = std::make_unique<component_set_type>();
                 _remove_funcs[id] = [](void* ptr, const entity_type& e) {
-                    static_cast<component_set_type*>(ptr)->remove(e);
+                    using hooks_invoker = hooks_invoker_type<T>;
+
+                    auto* cs = static_cast<component_set_type*>(ptr);
+
+                    if constexpr (hooks_invoker::has_on_remove) {
+                        hooks_invoker::on_remove(e, cs->get(e));
+                    }
+
+                    cs->remove(e);
+                };
+                _remove_all_funcs[id] = [](void* ptr) {
+                    using hooks_invoker = hooks_invoker_type<T>;
+
+                    auto* cs = static_cast<component_set_type*>(ptr);
+
+                    if constexpr (hooks_invoker::has_on_remove) {
+                        auto size = cs->size();
+                        for (size_type i = 0; i < size; ++i) {
+                            auto e = (*cs)[i];
+                            hooks_invoker::on_remove(e, cs->get(e));
+                        }
+                    }
+
+                    cs->remove_all();
                 };
             }
 
@@ -71,6 +71,16 @@ namespace mytho::storage {
             return idx < _versions.size() && _versions[idx] == e.version();
         }
 
+        void reserve(size_type size) {
+            base_type::reserve(size);
+            _versions.reserve(size);
+        }
+
+        void reset() noexcept {
+            base_type::reset();
+            _versions.clear();
+        }
+
         void clear() noexcept {
             base_type::clear();
             _versions.clear();
@@ -2,6 +2,7 @@
 #include <memory>
 #include <utility>
 #include <vector>
+#include <atomic>
 
 #include "storage/entity_set.hpp"
 
@@ -24,10 +25,20 @@ namespace mytho::storage {
 
         basic_entity_storage() noexcept = default;
         basic_entity_storage(const basic_entity_storage& es) = delete;
-        basic_entity_storage(basic_entity_storage&& es) noexcept = default;
+        basic_entity_storage(basic_entity_storage&& es) noexcept
+            : base_type(std::move(es)), _map(std::move(es._map)), _length(es._length),
+            _reserved(es._reserved.load(std::memory_order_relaxed)) {}
 
         basic_entity_storage& operator=(const basic_entity_storage& es) = delete;
-        basic_entity_storage& operator=(basic_entity_storage&& es) noexcept = default;
+
+        basic_entity_storage& operator=(basic_entity_storage&& es) noexcept {
+            base_type::operator=(std::move(es));
+            _map = std::move(es._map);
+            _length = es._length;
+            _reserved.store(es._reserved.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+            return *this;
+        }
 
         ~basic_entity_storage() noexcept = default;
 
@@ -60,14 +71,47 @@ namespace mytho::storage {
             }
         }
 
+        /*
+         * reserve an entity without touching the storage, it is safe to call concurrently.
+         * the reserved entities are taken from the dead entities first, then from the fresh ids,
+         * exactly in the order `emplace` would return them, and become alive at `flush`.
+         * must flush before any `emplace` or `pop`.
+         */
+        entity_type reserve_entity() noexcept {
+            return reserved(_length + _reserved.fetch_add(1, std::memory_order_relaxed));
+        }
+
+        template<typename OutputIt>
+        void reserve_entities(size_type count, OutputIt out) {
+            auto first = _length + _reserved.fetch_add(count, std::memory_order_relaxed);
+
+            for (auto idx = first; idx < first + count; ++idx) {
+                *out++ = reserved(idx);
+            }
+        }
+
+        void flush() {
+            auto count = _reserved.exchange(0, std::memory_order_relaxed);
+
+            if (count > 0) {
+                reserve(_length + count);
+            }
+
+            for (size_type i = 0; i < count; ++i) {
+                emplace();
+            }
+        }
+
         // must ensure entity exist
         void pop(const entity_type& e) noexcept {
             auto idx = base_type::index(e);
             base_type::version_next(e);
 
+            // the component ids are cleared even if the entity is the last one, its slot is reused by `emplace`
+            _map[idx]->clear();
+
             if (idx != (_length - 1)) {
                 base_type::swap(e, base_type::operator[](_length - 1));
-                _map[idx]->clear();
                 std::swap(_map[idx], _map[_length - 1]);
             }
 
@@ -106,13 +150,24 @@ namespace mytho::storage {
             return (!_has<Ts>(idx) && ...);
         }
 
+        // must ensure entity exist
+        const component_id_set_type& components(const entity_type& e) const noexcept {
+            return *_map[base_type::index(e)];
+        }
+
         bool contain(const entity_type& e) const noexcept {
             return base_type::contain(e) && base_type::index(e) < _length;
         }
 
+        void reserve(size_type size) {
+            base_type::reserve(size);
+            _map.reserve(size);
+        }
+
         void clear() noexcept {
             base_type::clear();
             _length = 0;
+            _reserved.store(0, std::memory_order_relaxed);
         }
 
     public:
@@ -129,6 +184,14 @@ namespace mytho::storage {
         const entity_type operator[](size_type idx) const { return base_type::operator[](idx); }
 
     private:
+        entity_type reserved(size_type idx) const noexcept {
+            if (idx < base_type::size()) {
+                return base_type::operator[](idx);
+            }
+
+            return entity_type(idx);
+        }
+
         template<typename T>
         void insert_components(const component_id_set_ptr_type& s) {
             auto id = component_id_generator::template gen<T>();
@@ -150,5 +213,6 @@ namespace mytho::storage {
     private:
         component_id_map_type _map;
         size_type _length = 0;
+        std::atomic<size_type> _reserved = 0;
     };
 }
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace mytho::storage {
+    template<typename EntityT>
+    class basic_removed_log final {
+    public:
+        using entity_type = EntityT;
+        using entities_type = std::vector<entity_type>;
+        using size_type = typename entities_type::size_type;
+        using cursor_type = uint64_t;
+
+        static constexpr size_type min_capacity = 16;
+
+        basic_removed_log() noexcept = default;
+        basic_removed_log(const basic_removed_log& rl) = delete;
+        basic_removed_log(basic_removed_log&& rl) noexcept = default;
+
+        basic_removed_log& operator=(const basic_removed_log& rl) = delete;
+        basic_removed_log& operator=(basic_removed_log&& rl) noexcept = default;
+
+        ~basic_removed_log() noexcept = default;
+
+    public:
+        void push(const entity_type& e, uint64_t tick) {
+            if (_head - _tail == _entities.size()) {
+                grow(_entities.size() + 1);
+            }
+
+            _entities[_head & (_entities.size() - 1)] = e;
+            ++_head;
+
+            _removed_tick = tick;
+        }
+
+        // push all entities of a container which has `size()` and `operator[]`, the ring buffer grows at most once
+        template<typename EntitiesT>
+        void append(const EntitiesT& entts, uint64_t tick) {
+            size_type size = entts.size();
+            if (size == 0) {
+                return;
+            }
+
+            if (_head - _tail + size > _entities.size()) {
+                grow(_head - _tail + size);
+            }
+
+            auto mask = _entities.size() - 1;
+            for (size_type i = 0; i < size; ++i) {
+                _entities[(_head + i) & mask] = entts[i];
+            }
+            _head += size;
+
+            _removed_tick = tick;
+        }
+
+        /*
+         * called once per frame, the records pushed before the previous update are dropped,
+         * so every record stays readable for two frames and readers never miss records
+         * no matter where they are scheduled.
+         */
+        void update() noexcept {
+            _tail = _frame;
+            _frame = _head;
+        }
+
+        // must ensure cursor in [tail, head)
+        const entity_type& operator[](cursor_type cursor) const noexcept {
+            return _entities[cursor & (_entities.size() - 1)];
+        }
+
+        bool removed(uint64_t tick) const noexcept {
+            return _head != 0 && _removed_tick >= tick;
+        }
+
+        void clear() noexcept {
+            _tail = _frame = _head;
+        }
+
+    public:
+        cursor_type tail() const noexcept { return _tail; }
+
+        cursor_type head() const noexcept { return _head; }
+
+        size_type size() const noexcept { return _head - _tail; }
+
+        bool empty() const noexcept { return _head == _tail; }
+
+    private:
+        // ring buffer, capacity is always power of two
+        entities_type _entities;
+        cursor_type _head = 0;
+        cursor_type _tail = 0;
+        cursor_type _frame = 0;
+        uint64_t _removed_tick = 0;
+
+    private:
+        // grow to the smallest power of two which holds `required` entities
+        void grow(size_type required) {
+            auto size = _entities.size();
+            auto new_size = size == 0 ? min_capacity : size * 2;
+            while (new_size < required) {
+                new_size *= 2;
+            }
+
+            entities_type entities(new_size);
+            for (auto c = _tail; c < _head; ++c) {
+                entities[c & (new_size - 1)] = _entities[c & (size - 1)];
+            }
+
+            _entities.swap(entities);
+        }
+    };
+}
\ No newline at end of file
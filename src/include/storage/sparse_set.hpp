@@ -87,6 +87,19 @@ namespace mytho::storage {
             return sparse[offset(data)] != data_null;
         }
 
+        void reserve(size_type size) {
+            _density.reserve(size);
+        }
+
+        // remove all data values but keep the pages, only the pages of the existing values are touched
+        void reset() noexcept {
+            for (auto data : _density) {
+                sparse_ref(data) = data_null;
+            }
+
+            _density.clear();
+        }
+
         void clear() noexcept {
             _density.clear();
             _sparsity.clear();
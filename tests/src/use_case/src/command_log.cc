@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <ecs/ecs.hpp>
+#include <string>
+
+using namespace mecs;
+
+/*-------------------------------------------------------------------- Test For Command Log Record And Replay ------------------------------------------------------------------------------------*/
+
+namespace clr {
+    struct Position {
+        float x;
+        float y;
+    };
+
+    struct Name {
+        std::string value;
+    };
+
+    struct Cache {
+        std::string value;
+    };
+
+    struct Frame {
+        int value;
+    };
+}
+
+template<>
+struct mytho::ecs::command_serializer<clr::Name> {
+    static void write(basic_command_writer& writer, const clr::Name& name) {
+        writer.write(uint32_t(name.value.size()));
+        writer.write(name.value.data(), name.value.size());
+    }
+
+    static clr::Name read(basic_command_reader& reader) {
+        clr::Name name;
+        name.value.resize(reader.read<uint32_t>());
+        reader.read(name.value.data(), name.value.size());
+
+        return name;
+    }
+};
+
+namespace clr {
+    void frame_init(Commands cmds) {
+        cmds.init_resource<Frame>(0);
+    }
+
+    void entity_spawn(Commands cmds, Res<Frame> r) {
+        auto [frame] = r;
+
+        auto e = cmds.spawn(Position{float(frame->value), 0.f});
+        cmds.insert(e, Name{"entity" + std::to_string(frame->value)});
+
+        // Cache has no serializer, so the command is skipped by the log
+        cmds.insert(e, Cache{"cache"});
+    }
+
+    void entity_update(Commands cmds, Querier<Entity, Position, Name> q) {
+        for (auto& [e, pos, name] : q) {
+            if (pos->x < 3.f) {
+                cmds.replace(*e, Position{pos->x, pos->y + 1.f});
+            } else {
+                cmds.despawn(*e);
+            }
+        }
+    }
+
+    void exit(Commands cmds, ResMut<Frame> rm) {
+        auto [frame] = rm;
+
+        if (++frame->value > 5) {
+            cmds.registry().exit();
+        }
+    }
+}
+
+TEST(CommandLogTest, RecordAndReplay) {
+    CommandLog log;
+    Registry reg;
+
+    reg.record_commands(&log)
+       .add_system<StartupSchedules::Startup>(clr::frame_init)
+       .add_system(clr::entity_spawn)
+       .add_system(system(clr::entity_update).after(clr::entity_spawn))
+       .add_system(system(clr::exit).after(clr::entity_update))
+       .run();
+
+    // startup frame and 6 main frames
+    EXPECT_EQ(7, log.frames());
+    EXPECT_EQ(6, log.skipped());
+
+    // replay into a fresh registry from a copy of the bytes, as if it is loaded from a file
+    CommandLog loaded(log.data());
+    EXPECT_EQ(log.frames(), loaded.frames());
+
+    Registry replayed;
+    size_t frames = 0;
+    loaded.replay(replayed, [&frames](uint64_t tick) {
+        EXPECT_GT(tick, 0);
+        ++frames;
+    });
+    EXPECT_EQ(log.frames(), frames);
+
+    auto q1 = reg.query<clr::Position, clr::Name>();
+    auto q2 = replayed.query<clr::Position, clr::Name>();
+    EXPECT_FALSE(q1.empty());
+    ASSERT_EQ(q1.size(), q2.size());
+
+    for (auto i = 0; i < q1.size(); ++i) {
+        auto& [p1, n1] = *(q1.begin() + i);
+        auto& [p2, n2] = *(q2.begin() + i);
+
+        EXPECT_EQ(p1->x, p2->x);
+        EXPECT_EQ(p1->y, p2->y);
+        EXPECT_EQ(n1->value, n2->value);
+    }
+
+    EXPECT_EQ(0, (replayed.count<Entity, With<clr::Cache>>()));
+
+    auto [frame] = replayed.resources<clr::Frame>();
+    EXPECT_EQ(0, frame->value);
+}
\ No newline at end of file
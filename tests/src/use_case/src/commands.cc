@@ -258,4 +258,365 @@ TEST(CommandsTest, ResourceOperation) {
        .add_system(system(cro::time_deinit).after(cro::time_update))
        .add_system(system(cro::exit).after(cro::frame_update))
        .run();
+}
+
+/*-------------------------------------------------------------------- Test For Commands Apply Order ------------------------------------------------------------------------------------*/
+
+namespace cao {
+    struct Value {
+        int value;
+    };
+
+    struct Frame {
+        int value;
+    };
+
+    void frame_init(Commands cmds) {
+        cmds.init_resource<Frame>(0);
+    }
+
+    void entity_spawn(Commands cmds) {
+        cmds.spawn(Value{0});
+    }
+
+    void value_reset(Commands cmds, Querier<Entity, Value> q) {
+        for (auto& [e, v] : q) {
+            cmds.replace(*e, Value{-1});
+        }
+    }
+
+    // runs after value_reset, so its commands are applied after the ones of value_reset
+    void value_increase(Commands cmds, Querier<Entity, Value> q) {
+        for (auto& [e, v] : q) {
+            cmds.replace(*e, Value{v->value + 1});
+        }
+    }
+
+    void check(Commands cmds, Querier<Entity, Value> q, ResMut<Frame> rm) {
+        auto [frame] = rm;
+
+        ++frame->value;
+
+        // the entity spawned at frame n has been increased (frame - n) times
+        auto size = q.size();
+        for (auto i = 0; i < size; ++i) {
+            auto& [e, v] = *(q.begin() + i);
+            EXPECT_EQ(v->value, size - 1 - i);
+        }
+
+        if (frame->value > 10) {
+            cmds.registry().exit();
+        }
+    }
+}
+
+TEST(CommandsTest, ApplyOrder) {
+    Registry reg;
+
+    reg.add_system<StartupSchedules::Startup>(cao::frame_init)
+       .add_system(cao::entity_spawn)
+       .add_system(system(cao::value_reset).after(cao::entity_spawn))
+       .add_system(system(cao::value_increase).after(cao::value_reset))
+       .add_system(system(cao::check).after(cao::value_increase))
+       .run();
+}
+
+/*-------------------------------------------------------------------- Test For Spawn With Reserved Entity ------------------------------------------------------------------------------------*/
+
+namespace csr {
+    struct Name {
+        std::string value;
+    };
+
+    struct Parent {
+        Entity entity;
+    };
+
+    struct Frame {
+        int value;
+    };
+
+    void frame_init(Commands cmds) {
+        cmds.init_resource<Frame>(0);
+    }
+
+    void family_despawn(Commands cmds, Querier<Entity, With<Name>> q) {
+        // despawn a part of entities, so the dead entities are reused by the reservation
+        auto size = q.size();
+        for (auto i = 0; i < size; i += 2) {
+            auto& [e] = *(q.begin() + i);
+            cmds.despawn(*e);
+        }
+    }
+
+    void family_spawn(Commands cmds, Res<Frame> r) {
+        auto [frame] = r;
+
+        for (auto i = 0; i < 3; ++i) {
+            auto name = std::to_string(frame->value) + "-" + std::to_string(i);
+            auto parent = cmds.spawn(Name{name});
+            cmds.spawn(Parent{parent}, Name{name + "-child"});
+
+            EXPECT_FALSE(cmds.registry().alive(parent));
+        }
+
+        cmds.spawn();
+    }
+
+    void family_check(Commands cmds, Querier<Entity, Name, Parent> q, ResMut<Frame> rm) {
+        auto [frame] = rm;
+
+        for (auto& [e, name, parent] : q) {
+            if (!cmds.registry().alive(parent->entity)) {
+                continue;
+            }
+
+            auto [parent_name] = cmds.registry().get<Name>(parent->entity);
+            EXPECT_EQ(parent_name.value + "-child", name->value);
+        }
+
+        // an entity without components is spawned every frame
+        EXPECT_EQ(frame->value, (cmds.registry().count<Entity, Without<Name>>()));
+
+        if (++frame->value > 10) {
+            cmds.registry().exit();
+        }
+    }
+}
+
+TEST(CommandsTest, SpawnReserved) {
+    Registry reg;
+
+    reg.add_system<StartupSchedules::Startup>(csr::frame_init)
+       .add_system(csr::family_despawn)
+       .add_system(system(csr::family_spawn).after(csr::family_despawn))
+       .add_system(system(csr::family_check).after(csr::family_spawn))
+       .run();
+}
+
+/*-------------------------------------------------------------------- Test For Batch Spawn ------------------------------------------------------------------------------------*/
+
+namespace csb {
+    struct Position {
+        float x;
+        float y;
+    };
+
+    struct Name {
+        std::string value;
+    };
+
+    void registry_spawn(Commands cmds) {
+        auto entts = cmds.registry().spawn_batch(100, [](size_t i) {
+            return std::make_tuple(Position{float(i), 0.f}, Name{"registry" + std::to_string(i)});
+        });
+
+        EXPECT_EQ(100, entts.size());
+        for (auto& e : entts) {
+            EXPECT_TRUE((cmds.registry().contain<Position, Name>(e)));
+        }
+    }
+
+    void commands_spawn(Commands cmds) {
+        std::vector<std::tuple<Name>> names;
+        for (auto i = 0; i < 50; ++i) {
+            names.emplace_back(Name{"commands" + std::to_string(i)});
+        }
+
+        auto entts = cmds.spawn_batch(std::move(names));
+        EXPECT_EQ(50, entts.size());
+
+        // the entities are reserved, later commands can refer to them
+        for (auto i = 0; i < entts.size(); ++i) {
+            EXPECT_FALSE(cmds.registry().alive(entts[i]));
+            cmds.insert(entts[i], Position{0.f, float(i)});
+        }
+    }
+
+    void check(Commands cmds, Querier<Entity, Position, Name> q) {
+        EXPECT_EQ(150, q.size());
+
+        for (auto& [e, pos, name] : q) {
+            if (name->value.starts_with("registry")) {
+                EXPECT_EQ(name->value, "registry" + std::to_string(int(pos->x)));
+            } else {
+                EXPECT_EQ(name->value, "commands" + std::to_string(int(pos->y)));
+            }
+        }
+
+        cmds.registry().exit();
+    }
+}
+
+TEST(CommandsTest, SpawnBatch) {
+    Registry reg;
+
+    reg.add_system<StartupSchedules::Startup>(csb::registry_spawn)
+       .add_system<StartupSchedules::Startup>(csb::commands_spawn)
+       .add_system(csb::check)
+       .run();
+}
+
+/*-------------------------------------------------------------------- Test For Commands On Despawned Entity ------------------------------------------------------------------------------------*/
+
+namespace cde {
+    struct Health {
+        int value;
+    };
+
+    struct Dead {};
+
+    struct Frame {
+        int value;
+    };
+
+    void entity_spawn(Commands cmds) {
+        cmds.init_resource<Frame>(0);
+
+        for (auto i = 0; i < 10; ++i) {
+            cmds.spawn(Health{i});
+        }
+    }
+
+    // both systems despawn the same entities, the later commands on them are dropped
+    void health_check(Commands cmds, Querier<Entity, Health> q) {
+        for (auto& [e, health] : q) {
+            if (health->value % 2 == 0) {
+                cmds.despawn(*e);
+            }
+        }
+    }
+
+    void health_clear(Commands cmds, Querier<Entity, Health> q) {
+        for (auto& [e, health] : q) {
+            if (health->value % 2 == 0) {
+                cmds.despawn(*e);
+                cmds.insert(*e, Dead{});
+            }
+        }
+    }
+
+    void check(Commands cmds, Querier<Entity, Health> q, ResMut<Frame> rm) {
+        auto [frame] = rm;
+
+        if (frame->value++ == 0) {
+            EXPECT_EQ(10, q.size());
+            return;
+        }
+
+        EXPECT_EQ(5, q.size());
+        for (auto& [e, health] : q) {
+            EXPECT_EQ(1, health->value % 2);
+        }
+
+        EXPECT_EQ(0, (cmds.registry().count<Entity, With<Dead>>()));
+
+        cmds.registry().exit();
+    }
+}
+
+TEST(CommandsTest, DespawnedEntity) {
+    Registry reg;
+
+    reg.add_system<StartupSchedules::Startup>(cde::entity_spawn)
+       .add_system(cde::check)
+       .add_system(system(cde::health_check).after(cde::check))
+       .add_system(system(cde::health_clear).after(cde::health_check))
+       .run();
+}
+
+/*-------------------------------------------------------------------- Test For Commands Despawn All And Clear ------------------------------------------------------------------------------------*/
+
+namespace cda {
+    struct Position {
+        int x;
+    };
+
+    struct Bullet {};
+
+    struct Stunned {};
+
+    struct Health {
+        int value;
+
+        inline static int removed = 0;
+
+        static void on_remove(const Entity& e, Health& health) {
+            ++removed;
+        }
+    };
+
+    struct Frame {
+        int value;
+    };
+
+    void entity_spawn(Commands cmds) {
+        cmds.init_resource<Frame>(0);
+
+        for (auto i = 0; i < 12; ++i) {
+            auto e = cmds.spawn(Position{i}, Health{i});
+
+            if (i % 2 == 0) {
+                cmds.insert(e, Bullet{});
+            }
+
+            if (i % 3 == 0) {
+                cmds.insert(e, Stunned{});
+            }
+        }
+    }
+
+    void check(Commands cmds, RemovedEntities<Stunned> stunned, RemovedEntities<Position> positions, ResMut<Frame> rm) {
+        auto [frame] = rm;
+        auto& reg = cmds.registry();
+
+        switch (frame->value++) {
+            case 0:
+                EXPECT_EQ(12, reg.count<Entity>());
+                EXPECT_EQ(6, (reg.count<Entity, With<Bullet>>()));
+                EXPECT_EQ(4, (reg.count<Entity, With<Stunned>>()));
+
+                cmds.despawn_all<With<Bullet>>();
+                cmds.clear<Stunned>();
+                break;
+            case 1: {
+                EXPECT_EQ(6, reg.count<Entity>());
+                EXPECT_EQ(0, (reg.count<Entity, With<Bullet>>()));
+                EXPECT_EQ(0, (reg.count<Entity, With<Stunned>>()));
+                EXPECT_EQ(6, Health::removed);
+
+                // the odd stunned entities lost Stunned, the even ones are despawned
+                EXPECT_EQ(4, stunned.size());
+                EXPECT_EQ(6, positions.size());
+
+                for (auto& [e, pos] : reg.query<Entity, Position>()) {
+                    EXPECT_EQ(1, pos->x % 2);
+                    EXPECT_FALSE(reg.contain<Stunned>(*e));
+                }
+
+                // the slot of a despawned entity is reused without its components, even if it is the last slot
+                reg.despawn(reg.spawn(Bullet{}));
+
+                auto e = reg.spawn(Position{100});
+                EXPECT_FALSE((reg.contain<Bullet>(e)));
+                EXPECT_FALSE((reg.contain<Stunned>(e)));
+
+                cmds.despawn_all();
+                break;
+            }
+            default:
+                EXPECT_EQ(0, reg.count<Entity>());
+                EXPECT_EQ(12, Health::removed);
+
+                cmds.registry().exit();
+        }
+    }
+}
+
+TEST(CommandsTest, DespawnAllAndClear) {
+    Registry reg;
+
+    reg.add_system<StartupSchedules::Startup>(cda::entity_spawn)
+       .add_system(cda::check)
+       .run();
 }
\ No newline at end of file
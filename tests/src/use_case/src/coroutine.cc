@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <ecs/ecs.hpp>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace mecs;
+using namespace std::chrono_literals;
+
+/*-------------------------------------------------------------------- Test For Task Systems ------------------------------------------------------------------------------------*/
+
+namespace tsk {
+    struct Position { float x; };
+
+    struct Progress {
+        int stage;
+        std::vector<size_t> seen;
+    };
+
+    // the query is bound again on each resume, so it sees the entities spawned between the frames
+    Task stream(Querier<Mut<Position>>& q, ResMut<Progress>& rm) {
+        auto [progress] = rm;
+
+        for (auto [pos] : q) {
+            pos->x += 1.0f;
+        }
+        progress->seen.push_back(q.size());
+        progress->stage = 1;
+
+        co_await next_frame();
+
+        for (auto [pos] : q) {
+            pos->x += 1.0f;
+        }
+        progress->seen.push_back(q.size());
+        progress->stage = 2;
+
+        co_await next_frame();
+
+        progress->seen.push_back(q.size());
+        progress->stage = 3;
+    }
+}
+
+TEST(CoroutineTest, NextFrame) {
+    using namespace tsk;
+
+    Registry reg;
+
+    reg.init_resource<Progress>(0, std::vector<size_t>{})
+       .add_system(stream);
+
+    reg.spawn(Position{ 0.0f });
+    reg.update(0ms);
+
+    reg.spawn(Position{ 0.0f });
+    reg.update(0ms);
+
+    reg.spawn(Position{ 0.0f });
+    reg.update(0ms);
+
+    {
+        auto [progress] = reg.resources<Progress>();
+        EXPECT_EQ(3, progress->stage);
+        EXPECT_EQ((std::vector<size_t>{ 1, 2, 3 }), progress->seen);
+    }
+
+    // the finished task starts over on the next run
+    reg.update(0ms);
+
+    auto [progress] = reg.resources<Progress>();
+    EXPECT_EQ(1, progress->stage);
+    EXPECT_EQ((std::vector<size_t>{ 1, 2, 3, 3 }), progress->seen);
+
+    float total = 0.0f;
+    for (auto [pos] : reg.query<Position>()) {
+        total += pos->x;
+    }
+    EXPECT_FLOAT_EQ(2.0f + 1.0f + 3.0f, total);
+}
+
+/*-------------------------------------------------------------------- Test For Task Budget ------------------------------------------------------------------------------------*/
+
+namespace tbg {
+    struct Batch {
+        int done;
+        std::vector<int> frames;
+    };
+
+    inline int frame = 0;
+
+    Task process(ResMut<Batch>& rm) {
+        for (int i = 0; i < 4; ++i) {
+            auto [batch] = rm;
+
+            std::this_thread::sleep_for(100us);
+            ++batch->done;
+            batch->frames.push_back(frame);
+
+            co_await budget_exhausted();
+        }
+    }
+
+    void count_frame() {
+        ++frame;
+    }
+}
+
+TEST(CoroutineTest, Budget) {
+    using namespace tbg;
+
+    // each item spends the budget, so one item runs in each frame
+    {
+        frame = 0;
+
+        Registry reg;
+
+        reg.init_resource<Batch>(0, std::vector<int>{})
+           .add_system(system(process).budget(1us))
+           .add_system<MainSchedules::Last>(count_frame);
+
+        reg.update(0ms).update(0ms);
+
+        auto [batch] = reg.resources<Batch>();
+        EXPECT_EQ(2, batch->done);
+        EXPECT_EQ((std::vector<int>{ 0, 1 }), batch->frames);
+    }
+
+    // without a budget the whole batch runs in one frame
+    {
+        frame = 0;
+
+        Registry reg;
+
+        reg.init_resource<Batch>(0, std::vector<int>{})
+           .add_system(process)
+           .add_system<MainSchedules::Last>(count_frame);
+
+        reg.update(0ms).update(0ms);
+
+        auto [batch] = reg.resources<Batch>();
+        EXPECT_EQ(8, batch->done);
+        EXPECT_EQ((std::vector<int>{ 0, 0, 0, 0, 1, 1, 1, 1 }), batch->frames);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <ecs/ecs.hpp>
+#include <chrono>
+#include <vector>
+
+using namespace mecs;
+using namespace std::chrono_literals;
+
+/*-------------------------------------------------------------------- Test For Fixed Timestep ------------------------------------------------------------------------------------*/
+
+namespace fts {
+    struct Bullet {};
+
+    inline int pre_steps = 0;
+    inline int steps = 0;
+    inline std::vector<size_t> frame_steps;
+
+    // the commands of the previous steps are applied
+    void bullet_check(Querier<Entity, Bullet> q) {
+        EXPECT_EQ(steps, q.size());
+        ++pre_steps;
+    }
+
+    void bullet_spawn(Commands cmds, Res<FixedTime> r) {
+        auto [time] = r;
+
+        EXPECT_EQ(10ms, time->timestep());
+        cmds.spawn(Bullet{});
+        ++steps;
+    }
+
+    void frame_record(Res<FixedTime> r) {
+        auto [time] = r;
+
+        frame_steps.push_back(time->steps());
+    }
+}
+
+TEST(FixedTimeTest, FixedTimestep) {
+    Registry reg;
+
+    reg.init_fixed_time(10ms, 3)
+       .add_system<FixedSchedules::FixedPreUpdate>(fts::bullet_check)
+       .add_system<FixedSchedules::FixedUpdate>(fts::bullet_spawn)
+       .add_system(fts::frame_record);
+
+    reg.update(0ms)
+       .update(25ms)
+       .update(5ms)
+       .update(100ms)
+       .update(15ms);
+
+    // a slow frame runs at most 3 steps, the time beyond them is dropped
+    std::vector<size_t> expected = { 0, 2, 1, 3, 1 };
+    EXPECT_EQ(expected, fts::frame_steps);
+    EXPECT_EQ(7, fts::steps);
+    EXPECT_EQ(7, fts::pre_steps);
+    EXPECT_EQ(7, (reg.count<Entity, fts::Bullet>()));
+
+    auto [time] = reg.resources<FixedTime>();
+    EXPECT_EQ(7, time->total_steps());
+    EXPECT_EQ(5ms, time->accumulated());
+    EXPECT_DOUBLE_EQ(0.5, time->overstep());
+}
+
+/*-------------------------------------------------------------------- Test For Frame Limiter ------------------------------------------------------------------------------------*/
+
+namespace ffl {
+    inline int frames = 0;
+
+    void exit(Commands cmds) {
+        if (++frames == 6) {
+            cmds.registry().exit();
+        }
+    }
+}
+
+TEST(FixedTimeTest, FrameLimiter) {
+    Registry reg;
+
+    auto begin = std::chrono::steady_clock::now();
+
+    reg.set_frame_limit(5ms)
+       .add_system(ffl::exit)
+       .run();
+
+    // the first frame starts the pacing, the other 5 frames end a period apart
+    EXPECT_GE(std::chrono::steady_clock::now() - begin, 25ms);
+    EXPECT_EQ(6, ffl::frames);
+    EXPECT_GT(reg.frame_delta(), 4ms);
+}
\ No newline at end of file
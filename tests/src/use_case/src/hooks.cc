@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <ecs/ecs.hpp>
+#include <string>
+#include <unordered_map>
+
+using namespace mecs;
+
+namespace hbo {
+    struct Name {
+        std::string value;
+
+        inline static std::unordered_map<std::string, Entity> index;
+
+        static void on_insert(const Entity& e, Name& name) {
+            index[name.value] = e;
+        }
+
+        static void on_replace(const Entity& e, Name& name) {
+            index.erase(name.value);
+        }
+
+        static void on_remove(const Entity& e, Name& name) {
+            index.erase(name.value);
+        }
+    };
+
+    struct Health {
+        int value;
+    };
+
+    struct Counter {
+        unsigned int added;
+        unsigned int removed;
+    };
+
+    inline Counter counter{0, 0};
+}
+
+// hooks attached from outside of the component type
+template<>
+struct mytho::storage::component_hooks<hbo::Health> {
+    static void on_add(const mecs::Entity& e, hbo::Health& health) {
+        ++hbo::counter.added;
+    }
+
+    static void on_remove(const mecs::Entity& e, hbo::Health& health) {
+        ++hbo::counter.removed;
+    }
+};
+
+namespace hbo {
+    void entity_spawn(Commands cmds) {
+        cmds.spawn(Name{std::string("entity") + std::to_string(counter.added)}, Health{100});
+    }
+
+    void entity_rename(Commands cmds, Querier<Entity, Name, With<Health>> q) {
+        for (auto& [e, name] : q) {
+            if (name->value.starts_with("entity")) {
+                cmds.replace(*e, Name{std::string("renamed") + std::to_string(e->id())});
+            }
+        }
+    }
+
+    void index_check(Commands cmds, Querier<Entity, Name> q) {
+        EXPECT_EQ(Name::index.size(), q.size());
+
+        for (auto& [e, name] : q) {
+            auto it = Name::index.find(name->value);
+            ASSERT_NE(it, Name::index.end());
+            EXPECT_EQ(it->second, *e);
+        }
+    }
+
+    void entity_despawn(Commands cmds, Querier<Entity, With<Health>> q) {
+        if (q.size() > 10) {
+            auto& [e] = *q.begin();
+            cmds.despawn(*e);
+        }
+    }
+
+    void exit(Commands cmds) {
+        if (counter.added > 50) {
+            cmds.registry().exit();
+        }
+    }
+}
+
+TEST(HooksTest, BasicOperation) {
+    {
+        Registry reg;
+
+        reg.add_system(hbo::entity_spawn)
+           .add_system(system(hbo::entity_rename).after(hbo::entity_spawn))
+           .add_system(system(hbo::index_check).after(hbo::entity_rename))
+           .add_system(system(hbo::entity_despawn).after(hbo::index_check))
+           .add_system(system(hbo::exit).after(hbo::entity_despawn))
+           .run();
+
+        EXPECT_EQ(hbo::counter.added, (hbo::counter.removed + reg.count<Entity, With<hbo::Health>>()));
+    }
+
+    hbo::Name::index.clear();
+}
\ No newline at end of file
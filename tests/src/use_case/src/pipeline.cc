@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <ecs/ecs.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace mecs;
+using namespace std::chrono_literals;
+
+/*-------------------------------------------------------------------- Test For Pipeline ------------------------------------------------------------------------------------*/
+
+namespace ppl {
+    struct Position { float x; };
+
+    struct Snapshot { float x; };
+
+    struct Output {
+        std::vector<float> frames;
+        std::vector<size_t> counts;
+        std::thread::id thread;
+    };
+
+    inline std::atomic<bool> release = false;
+
+    void movement(Querier<Mut<Position>> q) {
+        for (auto [pos] : q) {
+            pos->x += 1.0f;
+        }
+    }
+
+    void extract_positions(Querier<Position> q, Extract ext) {
+        for (auto [pos] : q) {
+            ext->spawn(Snapshot{ pos->x });
+        }
+    }
+
+    // the output stage of the sub-registry, it is held until the test releases it
+    void serialize(Querier<Snapshot> q, ResMut<Output> rm) {
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+
+        auto [output] = rm;
+
+        float total = 0.0f;
+        for (auto [snapshot] : q) {
+            total += snapshot->x;
+        }
+
+        output->frames.push_back(total);
+        output->counts.push_back(q.size());
+        output->thread = std::this_thread::get_id();
+    }
+}
+
+TEST(PipelineTest, Extract) {
+    using namespace ppl;
+
+    release = false;
+
+    Registry reg;
+
+    reg.init_pipeline()
+       .add_system(movement)
+       .add_system<ExtractSchedules::Extract>(extract_positions);
+
+    reg.sub_registry()
+       .init_resource<Output>()
+       .add_system(serialize);
+
+    reg.spawn(Position{ 0.0f });
+    reg.spawn(Position{ 10.0f });
+
+    reg.startup();
+
+    // the frame of the sub-registry is still held, the main frame is done
+    reg.update(0ms);
+
+    float total = 0.0f;
+    for (auto [pos] : reg.query<Position>()) {
+        total += pos->x;
+    }
+    EXPECT_FLOAT_EQ(12.0f, total);
+    EXPECT_TRUE(reg.pipelined());
+
+    release = true;
+    reg.wait_pipeline();
+
+    {
+        auto [output] = reg.sub_registry().resources<Output>();
+        EXPECT_EQ((std::vector<float>{ 12.0f }), output->frames);
+        EXPECT_NE(std::this_thread::get_id(), output->thread);
+    }
+
+    reg.update(0ms).update(0ms).wait_pipeline();
+
+    // the snapshots of each frame replace the ones of the previous frame
+    auto [output] = reg.sub_registry().resources<Output>();
+    EXPECT_EQ((std::vector<float>{ 12.0f, 14.0f, 16.0f }), output->frames);
+    EXPECT_EQ((std::vector<size_t>{ 2, 2, 2 }), output->counts);
+    EXPECT_EQ(2, (reg.sub_registry().count<Snapshot>()));
+
+    // the extract systems take turns on the sub-registry
+    EXPECT_TRUE(reg.schedule_report<ExtractSchedules::Extract>().ambiguities.empty());
+}
\ No newline at end of file
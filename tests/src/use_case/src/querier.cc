@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <ecs/ecs.hpp>
+#include <set>
 
 using namespace mecs;
 
@@ -96,4 +97,78 @@ TEST(QuerierTest, BasicOperation) {
        .add_system(system(qbo::final_check).after(qbo::position_and_velocity_change))
        .add_system(system(qbo::exit).after(qbo::final_check))
        .run();
+}
+
+namespace qoo {
+    struct Position {
+        float x;
+    };
+
+    struct Frame {
+        unsigned int value;
+    };
+
+    // ids of the entities changed since the last observer check
+    struct Pending {
+        std::set<Entity::id_type> ids;
+    };
+
+    void position_move(ResMut<Frame, Pending> r, Querier<Entity, Mut<Position>> q) {
+        auto [frame, pending] = r;
+
+        ++frame->value;
+        for (auto& [e, pos] : q) {
+            if ((e->id() + frame->value) % 7 == 0) {
+                pos->x += 1.f;
+                pending->ids.insert(e->id());
+            }
+        }
+    }
+
+    bool every_five_frames(Res<Frame> r) {
+        auto [frame] = r;
+
+        return frame->value % 5 == 0;
+    }
+
+    void observer_check(ResMut<Pending> r, Observer<Changed<Position>> changed_entts, Observer<Added<Position>> added_entts) {
+        auto [pending] = r;
+
+        std::set<Entity::id_type> ids;
+        for (auto& e : changed_entts) {
+            ids.insert(e.id());
+        }
+
+        EXPECT_EQ(ids.size(), changed_entts.size());
+        EXPECT_EQ(ids, pending->ids);
+
+        // all the entities are spawned before the first run
+        EXPECT_EQ(added_entts.size(), pending->ids.size() == 64 ? 64 : 0);
+
+        pending->ids.clear();
+    }
+
+    void exit(Commands cmds, Res<Frame> r) {
+        auto [frame] = r;
+
+        if (frame->value > 100) {
+            cmds.registry().exit();
+        }
+    }
+}
+
+TEST(QuerierTest, ObserverOperation) {
+    Registry reg;
+
+    std::set<Entity::id_type> ids;
+    for (auto i = 0; i < 64; ++i) {
+        ids.insert(reg.spawn(qoo::Position{0.f}).id());
+    }
+
+    reg.init_resource<qoo::Frame>(0u)
+       .init_resource<qoo::Pending>(std::move(ids))
+       .add_system(qoo::position_move)
+       .add_system(system(qoo::observer_check).after(qoo::position_move).runif(qoo::every_five_frames))
+       .add_system(system(qoo::exit).after(qoo::observer_check))
+       .run();
 }
\ No newline at end of file
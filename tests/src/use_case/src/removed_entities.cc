@@ -58,4 +58,54 @@ TEST(RemovedEntitiesTest, BasicOperation) {
        .add_system(system(rebo::entity_check).after(rebo::velocity_restore))
        .add_system(system(rebo::exit).after(rebo::entity_check))
        .run();
+}
+
+namespace reco {
+    struct Health {
+        int value;
+    };
+
+    struct Counter {
+        unsigned int spawned;
+        unsigned int removed;
+    };
+
+    // scheduled before the removals, each removed entity must be read exactly once in the next frame
+    void removed_count(ResMut<Counter> r, RemovedEntities<Health> entts) {
+        auto [counter] = r;
+
+        for (auto& e : entts) {
+            EXPECT_FALSE(e.id() == Entity::id_null);
+        }
+
+        counter->removed += entts.size();
+    }
+
+    void health_spawn_and_remove(Commands cmds, ResMut<Counter> r) {
+        auto [counter] = r;
+
+        auto e = cmds.registry().spawn(Health{10});
+        cmds.registry().remove<Health>(e);
+
+        ++counter->spawned;
+    }
+
+    void exit(Commands cmds, Res<Counter> r) {
+        auto [counter] = r;
+
+        if (counter->spawned > 100) {
+            EXPECT_EQ(counter->removed + 1, counter->spawned);
+            cmds.registry().exit();
+        }
+    }
+}
+
+TEST(RemovedEntitiesTest, CursorOperation) {
+    Registry reg;
+
+    reg.init_resource<reco::Counter>(0u, 0u)
+       .add_system(reco::removed_count)
+       .add_system(system(reco::health_spawn_and_remove).after(reco::removed_count))
+       .add_system(system(reco::exit).after(reco::health_spawn_and_remove))
+       .run();
 }
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <ecs/ecs.hpp>
+#include <sstream>
+#include <string>
+
+using namespace mecs;
+
+/*-------------------------------------------------------------------- Test For Schedule Report ------------------------------------------------------------------------------------*/
+
+namespace rpt {
+    enum class Sets { Score, Display };
+
+    struct Position { float x; };
+    struct Velocity { float x; };
+    struct Health { int value; };
+    struct Score { int value; };
+
+    void movement(Querier<Mut<Position>, Velocity> q) {}
+    void render(Querier<Position> q) {}
+    void damage(Querier<Mut<Health>> q) {}
+    void heal(Querier<Mut<Health>> q) {}
+    void score_update(ResMut<Score> rm) {}
+    void score_display(Res<Score> r) {}
+
+    void add_systems(Registry& reg) {
+        reg.init_resource<Score>(0)
+           .configure_set(system_set<Sets::Display>().after<Sets::Score>())
+           .add_system(system(movement).name("movement"))
+           .add_system(system(damage).name("damage"))
+           .add_system(system(heal).name("heal").after(damage))
+           .add_system(system(score_update).name("score update").in_set<Sets::Score>())
+           .add_system(system(score_display).name("score display").in_set<Sets::Display>());
+    }
+}
+
+TEST(ReportTest, Ambiguities) {
+    using namespace rpt;
+
+    Registry reg;
+    add_systems(reg);
+    reg.add_system(system(render).name("render"));
+
+    auto report = reg.schedule_report<MainSchedules::Update>();
+
+    EXPECT_EQ("mytho::ecs::main_schedules::Update", report.schedule);
+    EXPECT_EQ(6, report.systems.size());
+    EXPECT_EQ(2, report.critical_path());
+    EXPECT_EQ(4, report.max_parallelism());
+    EXPECT_EQ((std::vector<size_t>{ 4, 2 }), report.layer_widths);
+
+    // the ordering through the sets is an edge between the systems
+    ASSERT_EQ(2, report.edges.size());
+    for (auto& edge : report.edges) {
+        auto from = report.systems[edge.from].name;
+        auto to = report.systems[edge.to].name;
+
+        EXPECT_TRUE((from == "damage" && to == "heal") || (from == "score update" && to == "score display"));
+    }
+
+    // only the movement and the render are not ordered while they conflict
+    ASSERT_EQ(1, report.ambiguities.size());
+    auto& ambiguity = report.ambiguities[0];
+    EXPECT_EQ("movement", report.systems[ambiguity.first].name);
+    EXPECT_EQ("render", report.systems[ambiguity.second].name);
+    EXPECT_EQ((std::vector<std::string_view>{ "rpt::Position" }), ambiguity.components);
+    EXPECT_TRUE(ambiguity.resources.empty());
+    EXPECT_FALSE(ambiguity.exclusive);
+
+    std::ostringstream text;
+    report.write_text(text);
+    EXPECT_NE(std::string::npos, text.str().find("movement <-> render: component rpt::Position"));
+    EXPECT_NE(std::string::npos, text.str().find("critical path 2"));
+
+    std::ostringstream dot;
+    report.write_dot(dot);
+    EXPECT_EQ(0, dot.str().find("digraph \"mytho::ecs::main_schedules::Update\""));
+    EXPECT_NE(std::string::npos, dot.str().find("style=dashed"));
+    EXPECT_NE(std::string::npos, dot.str().find("label=\"movement\""));
+}
+
+TEST(ReportTest, NoAmbiguities) {
+    using namespace rpt;
+
+    Registry reg;
+    add_systems(reg);
+    reg.add_system(system(render).name("render").after(movement));
+
+    for (auto& report : reg.schedule_reports()) {
+        EXPECT_TRUE(report.ambiguities.empty()) << report.schedule;
+    }
+
+    auto report = reg.schedule_report<MainSchedules::Update>();
+    EXPECT_EQ(3, report.edges.size());
+    EXPECT_EQ(3, report.max_parallelism());
+}
\ No newline at end of file
@@ -2,6 +2,11 @@
 #include <ecs/ecs.hpp>
 #include <cstdio>
 #include <random>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <algorithm>
 
 using namespace mecs;
 
@@ -85,4 +90,583 @@ TEST(SystemTest, BasicOperation) {
             )
         )
        .run();
+}
+
+/*-------------------------------------------------------------------- Test For Parallel Executor ------------------------------------------------------------------------------------*/
+
+namespace spe {
+    struct Position {
+        float x;
+    };
+
+    struct Velocity {
+        float x;
+    };
+
+    struct Frame {
+        int value;
+    };
+
+    inline std::atomic<int> readers = 0;
+    inline std::atomic<int> max_readers = 0;
+    inline std::atomic<bool> writing = false;
+    inline std::atomic<int> overlaps = 0;
+
+    void read_begin() {
+        auto count = ++readers;
+
+        auto max = max_readers.load();
+        while (count > max && !max_readers.compare_exchange_weak(max, count)) {}
+
+        if (writing) {
+            ++overlaps;
+        }
+
+        // wait a moment for the other reader, which runs in the same wave
+        for (auto i = 0; i < 200 && readers < 2; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    void read_end() {
+        --readers;
+    }
+
+    void entity_spawn(Commands cmds) {
+        cmds.init_resource<Frame>(0);
+
+        for (auto i = 0; i < 100; ++i) {
+            cmds.spawn(Position{0.f}, Velocity{float(i)});
+        }
+    }
+
+    void position_read(Querier<Position> q) {
+        read_begin();
+        EXPECT_EQ(100, q.size());
+        read_end();
+    }
+
+    void velocity_read(Querier<Entity, Position, Velocity> q) {
+        read_begin();
+        EXPECT_EQ(100, q.size());
+        read_end();
+    }
+
+    // conflicts with both readers
+    void position_move(Querier<Mut<Position>, Velocity> q) {
+        writing = true;
+
+        if (readers > 0) {
+            ++overlaps;
+        }
+
+        for (auto& [pos, vel] : q) {
+            pos->x += vel->x;
+        }
+
+        writing = false;
+    }
+
+    void check(Commands cmds, Querier<Position, Velocity> q, ResMut<Frame> rm) {
+        auto [frame] = rm;
+
+        ++frame->value;
+        for (auto& [pos, vel] : q) {
+            EXPECT_EQ(pos->x, vel->x * frame->value);
+        }
+
+        if (frame->value == 3) {
+            cmds.registry().exit();
+        }
+    }
+}
+
+TEST(SystemTest, ParallelExecutor) {
+    Registry reg;
+
+    reg.set_thread_count(4)
+       .add_system<StartupSchedules::Startup>(spe::entity_spawn)
+       .add_system(spe::position_read)
+       .add_system(spe::velocity_read)
+       .add_system(spe::position_move)
+       .add_system(system(spe::check).after(spe::position_move))
+       .run();
+
+    EXPECT_EQ(2, spe::max_readers);
+    EXPECT_EQ(0, spe::overlaps);
+}
+
+/*-------------------------------------------------------------------- Test For Adding Systems At Runtime ------------------------------------------------------------------------------------*/
+
+namespace sar {
+    struct Frame {
+        int value;
+    };
+
+    inline std::vector<int> order;
+
+    void frame_init(Commands cmds) {
+        cmds.init_resource<Frame>(0);
+    }
+
+    void frame_count(ResMut<Frame> rm) {
+        auto [frame] = rm;
+
+        ++frame->value;
+        order.push_back(0);
+    }
+
+    void late(Res<Frame> r) {
+        order.push_back(1);
+    }
+
+    void later(Res<Frame> r) {
+        order.push_back(2);
+    }
+
+    // adds systems to its own schedule, they run from the next frame
+    void install(Commands cmds, Res<Frame> r) {
+        auto [frame] = r;
+
+        if (frame->value == 2) {
+            cmds.registry()
+                .add_system(system(later).after(late).after(late))
+                .add_system(system(late).after(frame_count));
+        }
+    }
+
+    void exit(Commands cmds, Res<Frame> r) {
+        auto [frame] = r;
+
+        if (frame->value == 4) {
+            cmds.registry().exit();
+        }
+    }
+}
+
+TEST(SystemTest, AddSystemAtRuntime) {
+    Registry reg;
+
+    reg.add_system<StartupSchedules::Startup>(sar::frame_init)
+       .add_system(sar::frame_count)
+       .add_system(system(sar::install).after(sar::frame_count).exclusive())
+       .add_system(system(sar::exit).after(sar::install))
+       .run();
+
+    std::vector<int> expected = { 0, 0, 0, 1, 2, 0, 1, 2 };
+    EXPECT_EQ(expected, sar::order);
+}
+
+/*-------------------------------------------------------------------- Test For Single Frame Stepping ------------------------------------------------------------------------------------*/
+
+namespace sss {
+    struct Counter {
+        int startups;
+        int frames;
+    };
+
+    void counter_init(Commands cmds) {
+        cmds.init_resource<Counter>(1, 0);
+    }
+
+    void frame_count(ResMut<Counter> rm) {
+        auto [counter] = rm;
+
+        ++counter->frames;
+    }
+
+    void exit(Commands cmds, Res<Counter> r) {
+        auto [counter] = r;
+
+        if (counter->frames == 3) {
+            cmds.registry().exit();
+        }
+    }
+}
+
+TEST(SystemTest, SingleFrameStepping) {
+    // two worlds stepped by the same loop
+    Registry w1, w2;
+
+    w1.add_system<StartupSchedules::Startup>(sss::counter_init)
+      .add_system(sss::frame_count)
+      .add_system(system(sss::exit).after(sss::frame_count));
+
+    w2.add_system<StartupSchedules::Startup>(sss::counter_init)
+      .add_system(sss::frame_count);
+
+    w1.startup().startup();
+
+    // the first update runs the startup schedules too
+    for (auto i = 0; i < 5; ++i) {
+        if (w1.running()) {
+            w1.update();
+        }
+
+        w2.update();
+    }
+
+    EXPECT_FALSE(w1.running());
+    EXPECT_TRUE(w2.running());
+
+    auto [c1] = w1.resources<sss::Counter>();
+    auto [c2] = w2.resources<sss::Counter>();
+    EXPECT_EQ(1, c1->startups);
+    EXPECT_EQ(3, c1->frames);
+    EXPECT_EQ(1, c2->startups);
+    EXPECT_EQ(5, c2->frames);
+}
+
+/*-------------------------------------------------------------------- Test For Schedule Lookup ------------------------------------------------------------------------------------*/
+
+namespace ssl {
+    enum class Custom {
+        Before,
+        After,
+        Replaced,
+        Manual,
+    };
+
+    inline std::vector<int> order;
+
+    void before() { order.push_back(0); }
+
+    void update() { order.push_back(1); }
+
+    void after() { order.push_back(2); }
+
+    void replaced() { order.push_back(3); }
+
+    void manual() { order.push_back(4); }
+}
+
+TEST(SystemTest, ScheduleLookup) {
+    Registry reg;
+
+    reg.add_schedule_before<ssl::Custom::Before, MainSchedules::Update>()
+       .add_schedule_after<ssl::Custom::Replaced, MainSchedules::Update>()
+       .add_system<ssl::Custom::Replaced>(ssl::replaced)
+       .insert_schedule<ssl::Custom::After, ssl::Custom::Replaced>()
+       .add_schedule<ssl::Custom::Manual>()
+       .add_system<ssl::Custom::Before>(ssl::before)
+       .add_system(ssl::update)
+       .add_system<ssl::Custom::After>(ssl::after)
+       .add_system<ssl::Custom::Manual>(ssl::manual);
+
+    reg.update();
+    reg.run_schedule<ssl::Custom::Manual>();
+    reg.update();
+
+    std::vector<int> expected = { 0, 1, 2, 4, 0, 1, 2 };
+    EXPECT_EQ(expected, ssl::order);
+}
+
+/*-------------------------------------------------------------------- Test For System Stats ------------------------------------------------------------------------------------*/
+
+namespace sst {
+    struct Position {
+        float x;
+    };
+
+    struct Frame {
+        int value;
+    };
+
+    void entity_spawn(Commands cmds) {
+        cmds.init_resource<Frame>(0);
+
+        for (auto i = 0; i < 10; ++i) {
+            cmds.spawn(Position{0.f});
+        }
+    }
+
+    void position_move(Querier<Mut<Position>> q) {
+        for (auto& [pos] : q) {
+            pos->x += 1.f;
+        }
+    }
+
+    bool never(Querier<Position> q) {
+        return false;
+    }
+
+    void skipped(Querier<Position> q) {}
+
+    void not_added() {}
+
+    void exit(Commands cmds, ResMut<Frame> rm) {
+        auto [frame] = rm;
+
+        if (++frame->value == 3) {
+            cmds.registry().exit();
+        }
+    }
+}
+
+TEST(SystemTest, SystemStats) {
+#if MYTHO_PROFILE_ENABLED
+    Registry reg;
+
+    reg.add_system<StartupSchedules::Startup>(sst::entity_spawn)
+       .add_system(sst::position_move)
+       .add_system(system(sst::skipped).runif(sst::never))
+       .add_system(system(sst::exit).after(sst::position_move))
+       .run();
+
+    auto move = reg.system_stats(sst::position_move);
+    ASSERT_NE(nullptr, move);
+    EXPECT_EQ(3, move->runs());
+    EXPECT_EQ(0, move->skips());
+    EXPECT_EQ(30, move->entities());
+    EXPECT_LE(move->percentile(0.5), move->max());
+    EXPECT_LE(move->percentile(0.99), move->max());
+    EXPECT_EQ(move->total() / 3, move->mean());
+
+    uint64_t count = 0;
+    for (auto c : move->histogram()) {
+        count += c;
+    }
+    EXPECT_EQ(3, count);
+
+    // the entities matched by the run condition are not counted for skipped runs
+    auto skipped = reg.system_stats(sst::skipped);
+    ASSERT_NE(nullptr, skipped);
+    EXPECT_EQ(0, skipped->runs());
+    EXPECT_EQ(3, skipped->skips());
+    EXPECT_EQ(0, skipped->entities());
+
+    EXPECT_EQ(nullptr, reg.system_stats(sst::not_added));
+
+    uint64_t runs = 0;
+    reg.each_system_stats([&runs](std::uintptr_t address, const auto& stats) {
+        runs += stats.runs();
+    });
+    EXPECT_GT(runs, 3);
+
+    reg.reset_system_stats();
+    EXPECT_EQ(0, move->runs());
+#else
+    GTEST_SKIP() << "system stats are compiled out";
+#endif
+}
+
+/*-------------------------------------------------------------------- Test For Memoized Run Conditions ------------------------------------------------------------------------------------*/
+
+namespace mrc {
+    struct Player { bool alive; };
+    struct Frame { int value; };
+
+    inline int alive_evals = 0;
+    inline int any_evals = 0;
+    inline int runs = 0;
+
+    // only reads resources, so it is evaluated once for all systems until `Player` changes
+    bool player_alive(Res<Player> r) {
+        auto [player] = r;
+
+        ++alive_evals;
+        return player->alive;
+    }
+
+    // takes a querier, so it is evaluated on each run
+    bool any_entity(Querier<Entity> q) {
+        ++any_evals;
+        return true;
+    }
+
+    void system_a() { ++runs; }
+    void system_b() { ++runs; }
+    void system_c() { ++runs; }
+    void system_d() { ++runs; }
+
+    void player_kill(Commands cmds, ResMut<Player, Frame> rm) {
+        auto [player, frame] = rm;
+
+        if (++frame->value == 2) {
+            player->alive = false;
+        }
+
+        if (frame->value == 4) {
+            cmds.registry().exit();
+        }
+    }
+}
+
+TEST(SystemTest, MemoizedRunConditions) {
+    using namespace mrc;
+
+    Registry reg;
+
+    reg.init_resource<Player>(true)
+       .init_resource<Frame>(0)
+       .add_system(system(system_a).runif(player_alive))
+       .add_system(system(system_b).runif(player_alive))
+       .add_system(system(system_c).runif(player_alive).runif(any_entity))
+       .add_system(system(system_d).runif(player_alive))
+       .add_system(system(player_kill).after(system_a).after(system_b).after(system_c).after(system_d));
+
+    reg.update();
+    EXPECT_EQ(1, alive_evals);
+    EXPECT_EQ(1, any_evals);
+    EXPECT_EQ(4, runs);
+
+    // the player is killed at the end of the second frame
+    reg.update();
+    EXPECT_EQ(1, alive_evals);
+    EXPECT_EQ(2, any_evals);
+    EXPECT_EQ(8, runs);
+
+    reg.update();
+    EXPECT_EQ(2, alive_evals);
+    EXPECT_EQ(2, any_evals);
+    EXPECT_EQ(8, runs);
+
+    reg.update();
+    EXPECT_EQ(2, alive_evals);
+    EXPECT_EQ(8, runs);
+    EXPECT_FALSE(reg.running());
+
+    // changes made outside the systems are seen too
+    auto [player] = reg.resources_mut<Player>();
+    player->alive = true;
+
+    reg.update();
+    EXPECT_EQ(3, alive_evals);
+    EXPECT_EQ(3, any_evals);
+    EXPECT_EQ(12, runs);
+}
+
+/*-------------------------------------------------------------------- Test For System Sets ------------------------------------------------------------------------------------*/
+
+namespace sts {
+    enum class Sets { Physics, Ai, Render };
+
+    inline std::vector<int> order;
+    inline bool ai_enabled = true;
+    inline int ai_evals = 0;
+
+    // not pure, so only the set evaluates it once for all its systems
+    bool ai_condition(Querier<Entity> q) {
+        ++ai_evals;
+        return ai_enabled;
+    }
+
+    void input() { order.push_back(0); }
+    void physics_a() { order.push_back(1); }
+    void physics_b() { order.push_back(1); }
+    void ai_a() { order.push_back(2); }
+    void ai_b() { order.push_back(2); }
+    void ai_c() { order.push_back(2); }
+    void render() { order.push_back(3); }
+    void present() { order.push_back(4); }
+}
+
+TEST(SystemTest, SystemSets) {
+    using namespace sts;
+
+    Registry reg;
+
+    // the systems are added in reverse, the sets order them
+    reg.configure_set(system_set<Sets::Physics>().before<Sets::Ai>())
+       .configure_set(system_set<Sets::Ai>().runif(ai_condition))
+       .add_system(system(present).after<Sets::Ai>().after<Sets::Render>())
+       .add_system(system(render).in_set<Sets::Render>().after<Sets::Ai>())
+       .add_system(system(ai_a).in_set<Sets::Ai>())
+       .add_system(system(ai_b).in_set<Sets::Ai>())
+       .add_system(system(ai_c).in_set<Sets::Ai>())
+       .add_system(system(physics_a).in_set<Sets::Physics>())
+       .add_system(system(physics_b).in_set<Sets::Physics>())
+       .add_system(system(input).before<Sets::Physics>());
+
+    reg.update();
+
+    ASSERT_EQ(8, order.size());
+    EXPECT_TRUE(std::is_sorted(order.begin(), order.end()));
+    EXPECT_EQ(1, ai_evals);
+
+    order.clear();
+    ai_enabled = false;
+    reg.update();
+
+    EXPECT_EQ(5, order.size());
+    EXPECT_EQ(0, std::count(order.begin(), order.end(), 2));
+    EXPECT_TRUE(std::is_sorted(order.begin(), order.end()));
+    EXPECT_EQ(2, ai_evals);
+}
+
+/*-------------------------------------------------------------------- Test For Exclusive And Main Thread Systems ------------------------------------------------------------------------------------*/
+
+namespace sem {
+    struct Position {
+        float x;
+    };
+
+    inline std::thread::id main_id;
+    inline std::atomic<int> readers = 0;
+    inline std::atomic<int> max_readers = 0;
+    inline std::atomic<int> overlaps = 0;
+    inline std::atomic<int> off_main = 0;
+    inline int frames = 0;
+
+    void read() {
+        auto count = ++readers;
+
+        auto max = max_readers.load();
+        while (count > max && !max_readers.compare_exchange_weak(max, count)) {}
+
+        // wait a moment for the other reader, which runs in the same wave
+        for (auto i = 0; i < 200 && readers < 2; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        --readers;
+    }
+
+    void reader_a(Querier<Position> q) { read(); }
+
+    void reader_b(Querier<Position> q) {
+        if (std::this_thread::get_id() != main_id) {
+            ++off_main;
+        }
+
+        read();
+    }
+
+    // takes the registry, so it is exclusive without being marked
+    void spawner(Registry& reg) {
+        if (readers > 0) {
+            ++overlaps;
+        }
+
+        if (std::this_thread::get_id() != main_id) {
+            ++off_main;
+        }
+
+        reg.spawn(Position{ 0.f });
+
+        if (++frames == 3) {
+            reg.exit();
+        }
+    }
+}
+
+TEST(SystemTest, ExclusiveAndMainThread) {
+    using namespace sem;
+
+    main_id = std::this_thread::get_id();
+
+    Registry reg;
+
+    // the spawner goes after both readers, so they still run together
+    reg.set_thread_count(4)
+       .add_system(sem::reader_a)
+       .add_system(sem::spawner)
+       .add_system(system(sem::reader_b).main_thread())
+       .run();
+
+    EXPECT_EQ(3, frames);
+    EXPECT_EQ(3, reg.count<Position>());
+    EXPECT_EQ(2, max_readers);
+    EXPECT_EQ(0, overlaps);
+    EXPECT_EQ(0, off_main);
 }
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <ecs/ecs.hpp>
+#include <atomic>
+#include <vector>
+#include <thread>
+
+using namespace mecs;
+
+/*-------------------------------------------------------------------- Test For Work Stealing Deque ------------------------------------------------------------------------------------*/
+
+TEST(TaskPoolTest, WorkStealingDeque) {
+    mytho::core::basic_work_stealing_deque<int> deque;
+
+    EXPECT_TRUE(deque.empty());
+    EXPECT_FALSE(deque.pop().has_value());
+    EXPECT_FALSE(deque.steal().has_value());
+
+    // more values than the initial capacity, so the ring grows
+    for (auto i = 0; i < 200; ++i) {
+        deque.push(i);
+    }
+
+    // the owner pops the newest, the thieves steal the oldest
+    EXPECT_EQ(199, deque.pop().value());
+    EXPECT_EQ(0, deque.steal().value());
+    EXPECT_EQ(1, deque.steal().value());
+
+    // every value is taken exactly once by the owner and the thieves
+    std::atomic<int> sum = 0;
+    std::atomic<int> taken = 0;
+    std::vector<std::thread> thieves;
+
+    for (auto i = 0; i < 3; ++i) {
+        thieves.emplace_back([&]() {
+            while (taken < 197) {
+                if (auto value = deque.steal()) {
+                    sum += value.value();
+                    ++taken;
+                }
+            }
+        });
+    }
+
+    while (taken < 197) {
+        if (auto value = deque.pop()) {
+            sum += value.value();
+            ++taken;
+        }
+    }
+
+    for (auto& thief : thieves) {
+        thief.join();
+    }
+
+    EXPECT_EQ(197, taken);
+    EXPECT_EQ(199 * 200 / 2 - 199 - 1, sum);
+    EXPECT_TRUE(deque.empty());
+}
+
+/*-------------------------------------------------------------------- Test For Task Pool Scope And Parallel For ------------------------------------------------------------------------------------*/
+
+TEST(TaskPoolTest, ScopeAndParallelFor) {
+    TaskPool pool(4);
+    EXPECT_EQ(4, pool.thread_count());
+
+    std::vector<int> values(10000, 0);
+    pool.parallel_for(0, values.size(), [&values](size_t i) { values[i] = int(i); }, 16);
+
+    for (auto i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(i, values[i]);
+    }
+
+    // nested scopes, the waiting threads run the tasks of the inner scopes
+    std::atomic<int> count = 0;
+    pool.scope([&pool, &count](auto& scope) {
+        for (auto i = 0; i < 8; ++i) {
+            scope.spawn([&pool, &count]() {
+                pool.parallel_for(0, 100, [&count](size_t) { ++count; });
+            });
+        }
+    });
+    EXPECT_EQ(800, count);
+
+    // a pool without workers runs everything on the caller thread
+    TaskPool single(1);
+    auto caller = std::this_thread::get_id();
+    single.parallel_for(0, 100, [caller](size_t) { EXPECT_EQ(caller, std::this_thread::get_id()); });
+}
+
+/*-------------------------------------------------------------------- Test For Parallel Query Iteration ------------------------------------------------------------------------------------*/
+
+namespace tpq {
+    struct Position {
+        float x;
+    };
+
+    struct Velocity {
+        float x;
+    };
+
+    struct Frame {
+        int value;
+    };
+
+    void entity_spawn(Commands cmds) {
+        cmds.init_resource<Frame>(0);
+
+        for (auto i = 0; i < 1000; ++i) {
+            cmds.spawn(Position{0.f}, Velocity{float(i)});
+        }
+    }
+
+    void position_move(Commands cmds, Querier<Mut<Position>, Velocity> q) {
+        EXPECT_NE(nullptr, cmds.registry().task_pool());
+
+        q.par_each(cmds.registry().task_pool(), [](auto& bundle) {
+            auto& [pos, vel] = bundle;
+            pos->x += vel->x;
+        }, 32);
+    }
+
+    void check(Commands cmds, Querier<Position, Velocity> q, ResMut<Frame> rm) {
+        auto [frame] = rm;
+
+        ++frame->value;
+        for (auto& [pos, vel] : q) {
+            EXPECT_EQ(pos->x, vel->x * frame->value);
+        }
+
+        if (frame->value == 3) {
+            cmds.registry().exit();
+        }
+    }
+}
+
+TEST(TaskPoolTest, ParallelQuery) {
+    Registry reg;
+    EXPECT_EQ(nullptr, reg.task_pool());
+
+    reg.set_thread_count(4)
+       .add_system<StartupSchedules::Startup>(tpq::entity_spawn)
+       .add_system(tpq::position_move)
+       .add_system(system(tpq::check).after(tpq::position_move))
+       .run();
+
+    EXPECT_EQ(4, reg.task_pool()->thread_count());
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <ecs/ecs.hpp>
+#include <sstream>
+#include <string>
+
+using namespace mecs;
+
+/*-------------------------------------------------------------------- Test For Trace ------------------------------------------------------------------------------------*/
+
+namespace trs {
+    struct Position { int x; };
+    struct Velocity { int x; };
+
+    inline int frames = 0;
+
+    void spawn(Commands cmds) {
+        cmds.spawn(Position{ 0 }, Velocity{ 1 });
+    }
+
+    void movement(Querier<Mut<Position>, Velocity> q) {
+        for (auto [pos, vel] : q) {
+            pos->x += vel->x;
+        }
+    }
+
+    void count(Commands cmds) {
+        if (++frames == 3) {
+            cmds.registry().exit();
+        }
+    }
+
+    size_t occurrences(const std::string& s, const std::string& pattern) {
+        size_t n = 0;
+        for (auto pos = s.find(pattern); pos != std::string::npos; pos = s.find(pattern, pos + pattern.size())) {
+            ++n;
+        }
+
+        return n;
+    }
+}
+
+TEST(TraceTest, ChromeTrace) {
+    using namespace trs;
+
+    Trace trace;
+    Registry reg;
+
+    reg.record_trace(&trace)
+       .add_system<StartupSchedules::Startup>(system(spawn).name("spawn"))
+       .add_system(system(movement).name("movement"))
+       .add_system(system(count).after(movement));
+
+    EXPECT_EQ(&trace, reg.trace());
+
+    reg.run();
+
+    EXPECT_EQ(3, frames);
+
+    size_t systems = 0;
+    trace.each([&systems](size_t thread, const Trace::event_type& event) {
+        EXPECT_EQ(0, thread);
+        EXPECT_GE(event.duration, 0);
+
+        if (event.category == "system" && event.name == "movement") {
+            ++systems;
+        }
+    });
+    EXPECT_EQ(3, systems);
+
+    std::ostringstream os;
+    trace.write(os);
+    auto json = os.str();
+
+    EXPECT_EQ(0, json.find("{\"traceEvents\":["));
+    EXPECT_EQ(1, occurrences(json, "\"name\":\"spawn\""));
+    EXPECT_EQ(3, occurrences(json, "\"name\":\"movement\""));
+    EXPECT_EQ(3, occurrences(json, "\"name\":\"system\""));
+    EXPECT_EQ(3, occurrences(json, "\"cat\":\"frame\""));
+    EXPECT_EQ(1, occurrences(json, "\"name\":\"mytho::ecs::startup_schedules::Startup\""));
+    EXPECT_EQ(3, occurrences(json, "\"name\":\"mytho::ecs::main_schedules::Update\""));
+    EXPECT_EQ(4, occurrences(json, "\"name\":\"startup apply\"") + occurrences(json, "\"name\":\"main apply\""));
+    EXPECT_LE(4, occurrences(json, "\"name\":\"apply commands\""));
+    EXPECT_EQ(trace.size(), occurrences(json, "\"ph\":\"X\""));
+
+    trace.clear();
+    EXPECT_EQ(0, trace.size());
+
+    // stop recording
+    reg.record_trace(nullptr).update();
+    EXPECT_EQ(0, trace.size());
+}
\ No newline at end of file